@@ -0,0 +1,184 @@
+/*
+AVLMultiTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef AVLMULTITREE_H
+#define AVLMULTITREE_H
+
+#include <vector>
+#include <utility>
+#include "AVLTree.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////AVL multi tree/////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// Every node keeps the records of one key in a vector, in insertion order, so
+// a key is compared once per level however many records it has.
+template<class T1, class T2 = NULLT, class Aug = NOAUG>
+class AVLMultiTree : public AVLTree<T1, vector<T2>, Aug> {
+
+public :
+	AVLMultiTree() {}
+	AVLMultiTree(int(*compare)(const T1 &a, const T1 &b)) : AVLTree<T1, vector<T2>, Aug>(compare) {}
+
+	bool Insert(const T1 &id);
+	bool Insert(const T1 &id, const T2 &rcd);
+	int count(const T1 &id) const;
+	pair<T2 *, T2 *> equalRange(const T1 &id) const;
+	int eraseOne(const T1 &id);
+	int eraseAll(const T1 &id);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To add a default record under the key "id".
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+bool AVLMultiTree<T1, T2, Aug>::Insert(const T1 &id) {
+	return Insert(id, T2());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To add a record after the ones already under the key "id".
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+bool AVLMultiTree<T1, T2, Aug>::Insert(const T1 &id, const T2 &rcd) {
+	bool fresh;
+	Node<T1, vector<T2>, Aug> *node = this->attach(this->root, id, NULL, fresh);
+	node->getRcd()->push_back(rcd);
+	this->refresh(node);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: count
+// DESCRIPTION: To count the records under the key "id".
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+int AVLMultiTree<T1, T2, Aug>::count(const T1 &id) const {
+	const Node<T1, vector<T2>, Aug> *node = this->findNode(id);
+	if (node == NULL)
+		return 0;
+	return (int)node->getRcd()->size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: equalRange
+// DESCRIPTION: To get the records under the key "id" as [first, last).
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: pair<T2 *, T2 *> - both NULL if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+pair<T2 *, T2 *> AVLMultiTree<T1, T2, Aug>::equalRange(const T1 &id) const {
+	const Node<T1, vector<T2>, Aug> *node = this->findNode(id);
+	if (node == NULL || node->getRcd()->empty())
+		return pair<T2 *, T2 *>((T2 *)NULL, (T2 *)NULL);
+	vector<T2> *rcds = node->getRcd();
+	return pair<T2 *, T2 *>(&rcds->front(), &rcds->front() + rcds->size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: eraseOne
+// DESCRIPTION: To erase the earliest record under the key "id". The key goes
+//				with its last record.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: int - the number of records erased
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+int AVLMultiTree<T1, T2, Aug>::eraseOne(const T1 &id) {
+	Node<T1, vector<T2>, Aug> *node = const_cast<Node<T1, vector<T2>, Aug> *>(this->findNode(id));
+	if (node == NULL)
+		return 0;
+	vector<T2> *rcds = node->getRcd();
+	if (rcds->size() > 1) {
+		rcds->erase(rcds->begin());
+		this->refresh(node);
+		return 1;
+	}
+	this->unlink(node);
+	delete node;
+	return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: eraseAll
+// DESCRIPTION: To erase the key "id" with all its records.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: int - the number of records erased
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug>
+int AVLMultiTree<T1, T2, Aug>::eraseAll(const T1 &id) {
+	Node<T1, vector<T2>, Aug> *node = const_cast<Node<T1, vector<T2>, Aug> *>(this->findNode(id));
+	int n;
+	if (node == NULL)
+		return 0;
+	n = (int)node->getRcd()->size();
+	this->unlink(node);
+	delete node;
+	return n;
+}
+
+#endif
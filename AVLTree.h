@@ -3,6 +3,12 @@ AVLTree.h
 
 Copyright (C) 2015-2019 Kingston Chan
 
+This is an altered version. Changes (C) 2026 agent <agent@local>: the
+balance policies, augmentation, lazy deletion, batch and range operations,
+finger search, coroutine lookups, statistics and the stored comparator,
+among others. Functions added or changed in 2026 are marked by the
+"agent 2026" dates in their headers; the "KC" dates are the original ones.
+
 This source code is provided 'as-is', without any express or implied
 warranty. In no event will the author be held liable for any damages
 arising from the use of this code.
@@ -32,10 +38,88 @@ Kingston Chan
 #include <fstream>
 #include <string>
 #include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <cstdint>
+#include <type_traits>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
 
 using namespace std;
 
+// Define AVL_PREFETCH before including this header to prefetch the grandsons
+// of every node compared on a lookup, which hides the cache misses of trees
+// much larger than the last level cache.
+#if defined(__GNUC__) || defined(__clang__)
+#define AVL_PF(p) __builtin_prefetch(p)
+#else
+#define AVL_PF(p) ((void)(p))
+#endif
+
+// With C++20 coroutines, AVL_CORO is defined and coFind is available: a
+// lookup that prefetches the next node and suspends instead of waiting for
+// it, so that an AVLSCHED running many of them overlaps their cache misses.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define AVL_CORO
+#include <coroutine>
+#include <deque>
+#include <exception>
+#endif
+
 class NULLT {};
+
+#ifdef AVL_CORO
+// A lazily started coroutine returning a T. It runs only when resumed, by an
+// AVLSCHED or by hand, and keeps its result until it is destroyed.
+template<class T>
+class AVLTASK {
+public :
+	struct promise_type {
+		T value;
+		AVLTASK get_return_object() { return AVLTASK(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+		std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+		void return_value(T v) { value = v; }
+		void unhandled_exception() { std::terminate(); }
+	};
+
+	AVLTASK(AVLTASK &&old) noexcept : h(old.h) { old.h = NULL; }
+	~AVLTASK() {
+		if (h)
+			h.destroy();
+	}
+	std::coroutine_handle<> handle() const { return h; }
+	bool done() const { return h.done(); }
+	const T &get() const { return h.promise().value; }
+private :
+	std::coroutine_handle<promise_type> h;
+	explicit AVLTASK(std::coroutine_handle<promise_type> handle) : h(handle) {}
+	AVLTASK(const AVLTASK &);
+};
+
+// Round robin over coroutines: every one is resumed in turn until it
+// finishes, so each runs a step while the memory of the others arrives.
+class AVLSCHED {
+public :
+	template<class T>
+	void add(const AVLTASK<T> &task) { ready.push_back(task.handle()); }
+	void run() {
+		std::coroutine_handle<> h;
+		while (!ready.empty()) {
+			h = ready.front();
+			ready.pop_front();
+			h.resume();
+			if (!h.done())
+				ready.push_back(h);
+		}
+	}
+private :
+	std::deque<std::coroutine_handle<> > ready;
+};
+#endif
+
 class AVLERR {
 public :
 	std::string error;
@@ -49,6 +133,9 @@ inline int MAX(int a, int b) {
 	return a > b ? a : b;
 }
 
+// The type of node counts, 64 bits so that a tree may hold more than 2^31 nodes.
+typedef long long AVLSIZE;
+
 template<typename T1>
 int dCmp(const T1 &a, const T1 &b) {
 	if (a > b)
@@ -58,43 +145,306 @@ int dCmp(const T1 &a, const T1 &b) {
 	return 0;
 }
 
+// Whether keys of T1 are small and trivial enough to be compared by value.
+template<class T1>
+class AVLBYVAL {
+public :
+	enum { value = is_trivially_copyable<T1>::value && sizeof(T1) <= sizeof(void *) };
+};
+
+// A comparator with no state, by the operators of T1 as dCmp, inlined into
+// the descents. Small trivial keys are taken by value, so that an integer
+// key is compared in registers; the result is formed without branches.
+template<class T1, bool byValue = AVLBYVAL<T1>::value>
+class AVLLESS {
+public :
+	int operator()(const T1 &a, const T1 &b) const { return (int)(a > b) - (int)(a < b); }
+};
+
+template<class T1>
+class AVLLESS<T1, true> {
+public :
+	int operator()(T1 a, T1 b) const { return (int)(a > b) - (int)(a < b); }
+};
+
+// The default comparator of a tree: a compare function, or AVLLESS inlined
+// when there is none or it is dCmp. A tree takes any class with
+// int operator()(const T1 &a, const T1 &b) const as its comparator, which
+// may carry state such as a collation table; one with no state costs the
+// tree no space.
+template<class T1>
+class AVLCMP {
+public :
+	int(*fn)(const T1 &a, const T1 &b);	// NULL for AVLLESS
+	AVLCMP(int(*compare)(const T1 &a, const T1 &b) = NULL) { fn = compare == dCmp<T1> ? NULL : compare; }
+	// a lambda with no captures, as taken by the compare function pointer before
+	template<class F, class = typename enable_if<is_convertible<F, int(*)(const T1 &, const T1 &)>::value>::type>
+	AVLCMP(F compare) : AVLCMP(static_cast<int(*)(const T1 &a, const T1 &b)>(compare)) {}
+	int operator()(const T1 &a, const T1 &b) const { return fn == NULL ? AVLLESS<T1>()(a, b) : fn(a, b); }
+};
+
+// Holds the comparator of a tree as a base, so that an empty one takes no
+// room, and keeps its members out of the tree's scope.
+template<class Cmp>
+class AVLCMPBOX : private Cmp {
+protected :
+	AVLCMPBOX(const Cmp &compare) : Cmp(compare) {}
+	const Cmp &comparator() const { return *this; }
+	void comparator(const Cmp &compare) { static_cast<Cmp &>(*this) = compare; }
+};
+
+// An augmentation keeps a value for every subtree, folded from the records
+// with a monoid:
+//	typedef ... value_type;
+//	static value_type identity();
+//	static value_type lift(const T1 &id, const T2 *rcd);
+//	static value_type combine(const value_type &a, const value_type &b);
+// combine must be associative; it is applied in inorder.
+class NOAUG {
+public :
+	typedef NULLT value_type;
+	static NULLT identity() { return NULLT(); }
+	template<class T1, class T2>
+	static NULLT lift(const T1 &id, const T2 *rcd) { return NULLT(); }
+	static NULLT combine(const NULLT &a, const NULLT &b) { return NULLT(); }
+};
+
+// The record of a Node. A set (T2 = NULLT) stores no record at all; its find
+// returns a shared dummy so that a found node is still told apart by non-NULL.
+template<class T2>
+class RCDSLOT {
+protected :
+	T2 *Rcd;	// record
+	RCDSLOT() { Rcd = NULL; }
+	void setRcd(const T2 *rcd) {
+		if (Rcd == NULL)
+			Rcd = new T2;
+		if (rcd != NULL)
+			*Rcd = *rcd;
+	}
+	void freeRcd() {
+		if (Rcd != NULL)
+			delete Rcd;
+		Rcd = NULL;
+	}
+	T2 *rcdPtr() const { return Rcd; }
+};
+
+template<>
+class RCDSLOT<NULLT> {
+protected :
+	void setRcd(const NULLT *rcd) {}
+	void freeRcd() {}
+	NULLT *rcdPtr() const {
+		static NULLT none;
+		return &none;
+	}
+};
+
+// whether an augmentation keeps nothing, so that rebalancing may stop early
+template<class Aug> struct AUGINFO { enum { none = 0 }; };
+template<> struct AUGINFO<NOAUG> { enum { none = 1 }; };
+
+// The rotation that a balance policy asks for at a node.
+enum BALACT { BALNONE, BALLL, BALLR, BALRR, BALRL };
+
+// A balance policy decides what the field of every node means and when a
+// node needs a rotation. It provides:
+//	typedef ... field_type;	// int for heights and ranks, wider for sizes
+//	enum { nil };	// the field of an empty subtree
+//	static field_type field(field_type l, field_type r, field_type self);	// a node's field from its sons'
+//	static bool heavier(field_type a, field_type b);	// a subtree too big to be b's sibling
+//	template<class N> static BALACT pick(N *node, field_type old);
+// pick is called bottom-up on every node whose sons have changed, "old" being
+// its field before. It may set the final fields of the nodes it rotates, and
+// rebalancing stops at the first node whose field is unchanged.
+
+// Strict AVL (the default): the field is the height, and the heights of two
+// sibling subtrees differ by one at most.
+class AVLBAL {
+public :
+	typedef int field_type;
+	enum { nil = -1 };
+	static int field(int l, int r, int self) { return MAX(l, r) + 1; }
+	static bool heavier(int a, int b) { return a > b + 1; }
+	template<class N>
+	static int of(const N *node) { return node == NULL ? nil : node->getHeight(); }
+	template<class N>
+	static BALACT pick(N *node, int old) {
+		int hl = of(node->getLft()), hr = of(node->getRgt());
+		if (hl - hr >= 2)
+			return of(node->getLft()->getLft()) >= of(node->getLft()->getRgt()) ? BALLL : BALLR;
+		if (hr - hl >= 2)
+			return of(node->getRgt()->getRgt()) >= of(node->getRgt()->getLft()) ? BALRR : BALRL;
+		return BALNONE;
+	}
+};
+
+// Weak AVL, a relaxed rank-balanced mode: the field is a rank, a son's rank
+// being 1 or 2 below its father's and a leaf's being 0. Insertions behave as
+// in AVL, but a deletion rotates at most twice, O(1) amortized rank changes.
+class WAVLBAL {
+public :
+	typedef int field_type;
+	enum { nil = -1 };
+	// a rank only rises when a son reaches it, i.e. on insertion
+	static int field(int l, int r, int self) { return self > MAX(l, r) ? self : MAX(l, r) + 1; }
+	static bool heavier(int a, int b) { return a > b + 1; }
+	template<class N>
+	static int of(const N *node) { return node == NULL ? nil : node->getHeight(); }
+	template<class N>
+	static BALACT pick(N *node, int old) {
+		N *l = node->getLft(), *r = node->getRgt();
+		int k = node->getHeight(), a = of(l), b = of(r), c, d;
+
+		if (k > old) {
+			// promoted by an insertion below: the other son may be 3 behind now
+			if (b == k - 3) {
+				node->ModifyHeight(old - 1);
+				if (of(l->getRgt()) == a - 2)
+					return BALLL;
+				l->ModifyHeight(old - 1);
+				l->getRgt()->ModifyHeight(old);
+				return BALLR;
+			}
+			if (a == k - 3) {
+				node->ModifyHeight(old - 1);
+				if (of(r->getLft()) == b - 2)
+					return BALRR;
+				r->ModifyHeight(old - 1);
+				r->getLft()->ModifyHeight(old);
+				return BALRL;
+			}
+			return BALNONE;
+		}
+
+		// after a deletion below
+		if (l == NULL && r == NULL) {
+			node->ModifyHeight(0);
+			return BALNONE;
+		}
+		if (b == k - 3) {
+			c = of(l->getLft());
+			d = of(l->getRgt());
+			if (a == k - 2 || (c == a - 2 && d == a - 2)) {
+				node->ModifyHeight(k - 1);
+				if (a == k - 1)
+					l->ModifyHeight(a - 1);
+				return BALNONE;
+			}
+			if (c == a - 1) {
+				node->ModifyHeight(d == nil && b == nil ? 0 : k - 1);
+				l->ModifyHeight(k);
+				return BALLL;
+			}
+			node->ModifyHeight(k - 2);
+			l->ModifyHeight(k - 2);
+			l->getRgt()->ModifyHeight(k);
+			return BALLR;
+		}
+		if (a == k - 3) {
+			c = of(r->getRgt());
+			d = of(r->getLft());
+			if (b == k - 2 || (c == b - 2 && d == b - 2)) {
+				node->ModifyHeight(k - 1);
+				if (b == k - 1)
+					r->ModifyHeight(b - 1);
+				return BALNONE;
+			}
+			if (c == b - 1) {
+				node->ModifyHeight(d == nil && a == nil ? 0 : k - 1);
+				r->ModifyHeight(k);
+				return BALRR;
+			}
+			node->ModifyHeight(k - 2);
+			r->ModifyHeight(k - 2);
+			r->getLft()->ModifyHeight(k);
+			return BALRL;
+		}
+		return BALNONE;
+	}
+};
+
+// Weight balanced, BB[alpha] with the parameters (3, 2): the field is the size
+// of the subtree, and neither side weighs more than 3 times the other, taking
+// a subtree of n nodes to weigh n + 1. Sizes change all the way up on every
+// update, but a node is only rotated when the weights really drift apart.
+// The sizes are 64 bits, like AVLSIZE.
+class WBBAL {
+public :
+	typedef AVLSIZE field_type;
+	enum { nil = 0 };
+	static AVLSIZE field(AVLSIZE l, AVLSIZE r, AVLSIZE self) { return l + r + 1; }
+	static bool heavier(AVLSIZE a, AVLSIZE b) { return a + 1 > 3 * (b + 1); }
+	template<class N>
+	static AVLSIZE of(const N *node) { return node == NULL ? nil : node->getHeight(); }
+	template<class N>
+	static BALACT pick(N *node, AVLSIZE old) {
+		AVLSIZE wl = of(node->getLft()) + 1, wr = of(node->getRgt()) + 1;
+		if (wl > 3 * wr)
+			return of(node->getLft()->getRgt()) + 1 < 2 * (of(node->getLft()->getLft()) + 1) ? BALLL : BALLR;
+		if (wr > 3 * wl)
+			return of(node->getRgt()->getLft()) + 1 < 2 * (of(node->getRgt()->getRgt()) + 1) ? BALRR : BALRL;
+		return BALNONE;
+	}
+};
+
+// whether the field of a policy is the height itself, so that getHeight need
+// not walk the tree
+template<class Bal> struct BALINFO { enum { height = 0 }; };
+template<> struct BALINFO<AVLBAL> { enum { height = 1 }; };
+
 ////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////Tree node/////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2 = NULLT>
-class Node {
+template<class T1, class T2, class Aug, class Bal, class Cmp> class AVLTree;
+
+template<class T1, class T2 = NULLT, class Aug = NOAUG, class Bal = AVLBAL>
+class Node : private RCDSLOT<T2> {
+
+	template<class, class, class, class, class> friend class AVLTree;
 
 private:
 	T1 ID;
-	T2 *Rcd;	// record
-	Node *Lft, *Rgt;
-	int height;
+	Node *Son[2];	// the left and right sons, picked as Son[cmp > 0]
+	Node *Par;	// parent, NULL for the root
+	typename Bal::field_type height;	// the balance field, the height in AVL
+	bool dead;	// a tombstone left by a lazy Delete
+	typename Aug::value_type Agg;	// augmentation of the subtree
+
+	void update();
+	typename Aug::value_type own() const { return dead ? Aug::identity() : Aug::lift(ID, getRcd()); }
 
 public:
 	// constructor and destructor
 	Node();
 	Node(const T1 &id, const T2 * const rcd = NULL);
 	Node(const T1 &id, const T2 &rcd);
-	Node(const Node<T1, T2> &New);
+	Node(const Node<T1, T2, Aug, Bal> &New);
 	~Node();
 
 	// modify the info of private members
 	bool ModifyID(const T1 &tmp);
-	bool ModifyHeight(int h);
-	bool operator=(const Node<T1, T2> &b);
+	bool ModifyHeight(typename Bal::field_type h);
+	bool operator=(const Node<T1, T2, Aug, Bal> &b);
 	bool operator=(const T1 &id);
-	bool copy(const Node<T1, T2> * const b);
-	bool AddLft(Node<T1, T2> *lft);
-	bool AddRgt(Node<T1, T2> *rgt);
+	bool copy(const Node<T1, T2, Aug, Bal> * const b);
+	bool AddLft(Node<T1, T2, Aug, Bal> *lft);
+	bool AddRgt(Node<T1, T2, Aug, Bal> *rgt);
 	bool AddLft(const T1 &lftID, const T2 * const lftRcd = NULL);
 	bool AddRgt(const T1 &rgtID, const T2 * const RgtRcd = NULL);
 
 	// get the info of private members
-	Node<T1, T2> *getLft() const { return Lft; }
-	Node<T1, T2> *getRgt() const { return Rgt; }
-	int getHeight() const { return height; }
+	Node<T1, T2, Aug, Bal> *getLft() const { return Son[0]; }
+	Node<T1, T2, Aug, Bal> *getRgt() const { return Son[1]; }
+	Node<T1, T2, Aug, Bal> *getPar() const { return Par; }
+	Node<T1, T2, Aug, Bal> *next() const;
+	Node<T1, T2, Aug, Bal> *prev() const;
+	typename Bal::field_type getHeight() const { return height; }
+	bool isDead() const { return dead; }
+	const typename Aug::value_type &getAgg() const { return Agg; }
 	const T1 &getID() const { return ID; }
-	T2 *getRcd() const { return Rcd; }
+	T2 *getRcd() const { return this->rcdPtr(); }
 	void print() const;
 };
 
@@ -103,17 +453,18 @@ public:
 // DESCRIPTION: Constructor of Node class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: height, Rcd, Lft, Rgt
+// MODIFIES GL: height, Rcd, Son
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node() {
-	height = 0;
-	Rcd = new T2;
-	Lft = Rgt = NULL;
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal>::Node() {
+	height = Bal::field(Bal::nil, Bal::nil, 0);
+	dead = false;
+	this->setRcd(NULL);
+	Son[0] = Son[1] = Par = NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -122,20 +473,20 @@ Node<T1, T2>::Node() {
 //   ARGUMENTS: const T1 &id - the ID of the node
 //				const T2 * const rcd - the initial record with default value NULL
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, Son, Agg
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const T1 &id, const T2 * const rcd) {
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal>::Node(const T1 &id, const T2 * const rcd) {
 	ID = id;
-	Rcd = new T2;
-	if (rcd != NULL)
-		*Rcd = *rcd;
-	Lft = Rgt = NULL;	// no sons at first
-	height = 0;
+	this->setRcd(rcd);
+	Son[0] = Son[1] = Par = NULL;	// no sons at first
+	height = Bal::field(Bal::nil, Bal::nil, 0);
+	dead = false;
+	Agg = Aug::lift(ID, getRcd());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -144,34 +495,36 @@ Node<T1, T2>::Node(const T1 &id, const T2 * const rcd) {
 //   ARGUMENTS: const T1 &id - the ID of the node
 //				const T2 &rcd - the initial record
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, Son, Agg
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const T1 &id, const T2 &rcd) {
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal>::Node(const T1 &id, const T2 &rcd) {
 	ID = id;
-	Rcd = new T2;
-	*Rcd = rcd;
-	Lft = Rgt = NULL;	// no sons at first
-	height = 0;
+	this->setRcd(&rcd);
+	Son[0] = Son[1] = Par = NULL;	// no sons at first
+	height = Bal::field(Bal::nil, Bal::nil, 0);
+	dead = false;
+	Agg = Aug::lift(ID, getRcd());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: Node
 // DESCRIPTION: Copy constructor of Node class.
-//   ARGUMENTS: const Node<T1, T2> &New - the Node that is to be copied
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> &New - the Node that is to be copied
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, Son, Par
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::Node(const Node<T1, T2> &New) {
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal>::Node(const Node<T1, T2, Aug, Bal> &New) {
+	Son[0] = Son[1] = Par = NULL;
 	copy(&New);
 }
 
@@ -180,20 +533,19 @@ Node<T1, T2>::Node(const Node<T1, T2> &New) {
 // DESCRIPTION: Destructor of Node class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height, Lft, Rgt
+// MODIFIES GL: ID, Rcd, height, Son
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
-////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>::~Node() {
-	if (Rcd != NULL)
-		delete Rcd;
-	if (Lft != NULL)
-		delete Lft;
-	if (Rgt != NULL)
-		delete Rgt;
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal>::~Node() {
+	this->freeRcd();
+	if (Son[0] != NULL)
+		delete Son[0];
+	if (Son[1] != NULL)
+		delete Son[1];
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -207,8 +559,8 @@ Node<T1, T2>::~Node() {
 // AUTHOR/DATE: KC 2015-02-05
 //							KC 2015-02-05
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::ModifyID(const T1 &tmp) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::ModifyID(const T1 &tmp) {
 	ID = tmp;
 	return true;
 }
@@ -216,16 +568,16 @@ bool Node<T1, T2>::ModifyID(const T1 &tmp) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: ModifyHeight
 // DESCRIPTION: To modify the height of a Node.
-//   ARGUMENTS: int h - the new height value
+//   ARGUMENTS: typename Bal::field_type h - the new height value
 // USES GLOBAL: none
 // MODIFIES GL: height
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::ModifyHeight(int h) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::ModifyHeight(typename Bal::field_type h) {
 	height = h;
 	return true;
 }
@@ -233,16 +585,16 @@ bool Node<T1, T2>::ModifyHeight(int h) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: copy
 // DESCRIPTION: To copy the node and their sons.
-//   ARGUMENTS: const Node<T1, T2> * const b - the new node that is to be copied
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> * const b - the new node that is to be copied
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, Lft, Rgt, height
+// MODIFIES GL: ID, Rcd, Son, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-08
-//							KC 2015-02-08
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::copy(const Node<T1, T2> * const b) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::copy(const Node<T1, T2, Aug, Bal> * const b) {
 
 	// avoid self copy after deletion
 	if (b == this)
@@ -250,42 +602,36 @@ bool Node<T1, T2>::copy(const Node<T1, T2> * const b) {
 
 	// copy ID, record and height
 	ID = b->ID;
-	if (b->Rcd != NULL) {
-		if (Rcd == NULL)
-			Rcd = new T2;
-		*Rcd = *(b->Rcd);
-	}
-	else {
-		if (Rcd != NULL) {
-			delete Rcd;
-			Rcd = NULL;
-		}
-	}
+	this->setRcd(b->getRcd());
 	height = b->height;
+	dead = b->dead;
+	Agg = b->Agg;
 
 	// copy the left son
-	if (b->Lft != NULL) {
-		if (Lft == NULL)
-			Lft = new Node<T1, T2>;
-		Lft->copy(b->Lft);
+	if (b->Son[0] != NULL) {
+		if (Son[0] == NULL)
+			Son[0] = new Node<T1, T2, Aug, Bal>;
+		Son[0]->copy(b->Son[0]);
+		Son[0]->Par = this;
 	}
 	else {
-		if (Lft != NULL) {
-			delete Lft;
-			Lft = NULL;
+		if (Son[0] != NULL) {
+			delete Son[0];
+			Son[0] = NULL;
 		}
 	}
 
 	// copy the right son
-	if (b->Rgt != NULL) {
-		if (Rgt == NULL)
-			Rgt = new Node<T1, T2>;
-		Rgt->copy(b->Rgt);
+	if (b->Son[1] != NULL) {
+		if (Son[1] == NULL)
+			Son[1] = new Node<T1, T2, Aug, Bal>;
+		Son[1]->copy(b->Son[1]);
+		Son[1]->Par = this;
 	}
 	else {
-		if (Rgt != NULL) {
-			delete Rgt;
-			Rgt = NULL;
+		if (Son[1] != NULL) {
+			delete Son[1];
+			Son[1] = NULL;
 		}
 	}
 
@@ -295,21 +641,23 @@ bool Node<T1, T2>::copy(const Node<T1, T2> * const b) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: operator=
 // DESCRIPTION: copy the content of a Node.
-//   ARGUMENTS: const Node<T1, T2> &b - the Node that is to be assigned
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> &b - the Node that is to be assigned
 // USES GLOBAL: none
-// MODIFIES GL: ID, Rcd, height
+// MODIFIES GL: ID, Rcd, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-09
-//							KC 2015-02-09
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::operator=(const Node<T1, T2> &b) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::operator=(const Node<T1, T2, Aug, Bal> &b) {
 	if (&b == this)
 		return true;
 	ID = b.getID();
-	*Rcd = *(b.getRcd());
+	this->setRcd(b.getRcd());
 	height = b.getHeight();
+	dead = b.dead;
+	Agg = b.Agg;
 	return true;
 }
 
@@ -324,8 +672,8 @@ bool Node<T1, T2>::operator=(const Node<T1, T2> &b) {
 // AUTHOR/DATE: KC 2015-02-10
 //							KC 2015-02-10
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::operator=(const T1 &id) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::operator=(const T1 &id) {
 	ID = id;
 	return true;
 }
@@ -333,25 +681,21 @@ bool Node<T1, T2>::operator=(const T1 &id) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AddLft
 // DESCRIPTION: Concatenate a left son.
-//   ARGUMENTS: Node<T1, T2> *lft - the left son that is to be concatenated
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *lft - the left son that is to be concatenated
 // USES GLOBAL: none
-// MODIFIES GL: Lft, height
+// MODIFIES GL: Son[0], Par, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddLft(Node<T1, T2> *lft) {
-
-	Lft = lft; // assign the left son
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::AddLft(Node<T1, T2, Aug, Bal> *lft) {
 
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+	Son[0] = lft; // assign the left son
+	if (Son[0] != NULL)
+		Son[0]->Par = this;
+	update();
 
 	return true;
 }
@@ -362,24 +706,19 @@ bool Node<T1, T2>::AddLft(Node<T1, T2> *lft) {
 //   ARGUMENTS: const T1 &lftID - the ID of the left son that is to be concatenated
 //				const T2 * const lftRcd - the record of the left son
 // USES GLOBAL: none
-// MODIFIES GL: Lft, height
+// MODIFIES GL: Son[0], Par, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddLft(const T1 &lftID, const T2 * const lftRcd) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::AddLft(const T1 &lftID, const T2 * const lftRcd) {
 
 	Node *Tmp = new Node(lftID, lftRcd);
-	Lft = Tmp;
-
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+	Son[0] = Tmp;
+	Son[0]->Par = this;
+	update();
 
 	return true;
 }
@@ -387,25 +726,21 @@ bool Node<T1, T2>::AddLft(const T1 &lftID, const T2 * const lftRcd) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AddRgt
 // DESCRIPTION: Concatenate a right son.
-//   ARGUMENTS: Node<T1, T2> *rgt - the right son that is to be concatenated
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *rgt - the right son that is to be concatenated
 // USES GLOBAL: none
-// MODIFIES GL: Rgt, height
+// MODIFIES GL: Son[1], Par, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddRgt(Node<T1, T2> *rgt) {
-
-	Rgt = rgt; // assign the left son
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::AddRgt(Node<T1, T2, Aug, Bal> *rgt) {
 
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+	Son[1] = rgt; // assign the right son
+	if (Son[1] != NULL)
+		Son[1]->Par = this;
+	update();
 
 	return true;
 }
@@ -416,28 +751,103 @@ bool Node<T1, T2>::AddRgt(Node<T1, T2> *rgt) {
 //   ARGUMENTS: const T1 &rgtID - the ID of the right son that is to be concatenated
 //				const T2 * const RgtRcd - the record of the right son
 // USES GLOBAL: none
-// MODIFIES GL: Rgt, height
+// MODIFIES GL: Son[1], Par, height, Agg
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-05
-//							KC 2015-02-05
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool Node<T1, T2>::AddRgt(const T1 &rgtID, const T2 * const RgtRcd = NULL) {
+template<class T1, class T2, class Aug, class Bal>
+bool Node<T1, T2, Aug, Bal>::AddRgt(const T1 &rgtID, const T2 * const RgtRcd) {
 
 	Node *Tmp = new Node(rgtID, RgtRcd);
-	Rgt = Tmp;
-
-	// update the height
-	height = 0;
-	if (Lft != NULL)
-		height = MAX(height, Lft->height + 1);
-	if (Rgt != NULL)
-		height = MAX(height, Rgt->height + 1);
+	Son[1] = Tmp;
+	Son[1]->Par = this;
+	update();
 
 	return true;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: update
+// DESCRIPTION: To recompute the height and the augmentation of a Node from its
+//				two sons.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: height, Agg
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+void Node<T1, T2, Aug, Bal>::update() {
+	height = Bal::field(Son[0] != NULL ? Son[0]->height : Bal::nil, Son[1] != NULL ? Son[1]->height : Bal::nil, height);
+	if (!AUGINFO<Aug>::none)
+		Agg = Aug::combine(Aug::combine(Son[0] != NULL ? Son[0]->Agg : Aug::identity(),
+			own()), Son[1] != NULL ? Son[1]->Agg : Aug::identity());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: next
+// DESCRIPTION: To find the in-order successor of a Node through the parents,
+//				skipping tombstones.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal> *Node<T1, T2, Aug, Bal>::next() const {
+	const Node<T1, T2, Aug, Bal> *p = this;
+	do {
+		if (p->Son[1] != NULL) {
+			p = p->Son[1];
+			while (p->Son[0] != NULL)
+				p = p->Son[0];
+		}
+		else {
+			while (p->Par != NULL && p->Par->Son[1] == p)
+				p = p->Par;
+			p = p->Par;
+		}
+	} while (p != NULL && p->dead);
+	return const_cast<Node<T1, T2, Aug, Bal> *>(p);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: prev
+// DESCRIPTION: To find the in-order predecessor of a Node through the parents,
+//				skipping tombstones.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+Node<T1, T2, Aug, Bal> *Node<T1, T2, Aug, Bal>::prev() const {
+	const Node<T1, T2, Aug, Bal> *p = this;
+	do {
+		if (p->Son[0] != NULL) {
+			p = p->Son[0];
+			while (p->Son[1] != NULL)
+				p = p->Son[1];
+		}
+		else {
+			while (p->Par != NULL && p->Par->Son[0] == p)
+				p = p->Par;
+			p = p->Par;
+		}
+	} while (p != NULL && p->dead);
+	return const_cast<Node<T1, T2, Aug, Bal> *>(p);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: print
 // DESCRIPTION: To print the Node's ID, height and two sons.
@@ -447,122 +857,263 @@ bool Node<T1, T2>::AddRgt(const T1 &rgtID, const T2 * const RgtRcd = NULL) {
 //     RETURNS: void
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-11
-//							KC 2015-02-11
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-void Node<T1, T2>::print() const{
+template<class T1, class T2, class Aug, class Bal>
+void Node<T1, T2, Aug, Bal>::print() const{
 	cout << ID << ": h-" << height << "  l-";
-	if (Lft != NULL)
-		cout << '(' << Lft->getID() << ')';
+	if (Son[0] != NULL)
+		cout << '(' << Son[0]->getID() << ')';
 	cout << "  r-";
-	if (Rgt != NULL)
-		cout << '(' << Rgt->getID() << ')';
+	if (Son[1] != NULL)
+		cout << '(' << Son[1]->getID() << ')';
 	cout << endl;
-	if (Lft != NULL)
-		Lft->print();
-	if (Rgt != NULL)
-		Rgt->print();
+	if (Son[0] != NULL)
+		Son[0]->print();
+	if (Son[1] != NULL)
+		Son[1]->print();
+}
+
+// The shape and memory of a tree, as measured by AVLTree::stats. The balance
+// factor of a node is the height of its right subtree less that of its left
+// one, measured, whatever the balance policy keeps. Slack is what the
+// allocator hands out beyond the bytes asked for: exact with glibc, an
+// estimate for 16 byte chunks with an 8 byte header elsewhere. farLinks is
+// the share of parent to son links that cross a 4K page, a measure of how
+// scattered the nodes are in memory.
+class AVLSTATS {
+public :
+	AVLSIZE nodes;	// including tombstones
+	AVLSIZE tombs;
+	int height;	// as getHeight: 0 for a leaf, -1 for an empty tree
+	int maxDepth;	// the root at depth 0
+	double avgDepth;
+	map<int, AVLSIZE> balance;	// balance factor -> nodes
+	AVLSIZE nodeBytes, rcdBytes, slackBytes;
+	double farLinks;
+	AVLSTATS() : nodes(0), tombs(0), height(-1), maxDepth(0), avgDepth(0),
+		nodeBytes(0), rcdBytes(0), slackBytes(0), farLinks(0) {}
+	bool toJSON(ostream &out = cout) const;
+	static AVLSIZE slack(const void *p, size_t bytes);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: slack
+// DESCRIPTION: To find the bytes the allocator gave a block beyond "bytes".
+//   ARGUMENTS: const void *p - the block, from new
+//				size_t bytes - the bytes asked for
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLSIZE
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+inline AVLSIZE AVLSTATS::slack(const void *p, size_t bytes) {
+#ifdef __GLIBC__
+	return (AVLSIZE)(malloc_usable_size(const_cast<void *>(p)) - bytes);
+#else
+	size_t chunk = (bytes + 8 + 15) & ~(size_t)15;
+	return (AVLSIZE)((chunk < 32 ? 32 : chunk) - 8 - bytes);
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: toJSON
+// DESCRIPTION: To write the statistics as one JSON object.
+//   ARGUMENTS: ostream &out = cout - the stream
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+inline bool AVLSTATS::toJSON(ostream &out) const {
+	map<int, AVLSIZE>::const_iterator it;
+	out << "{\"nodes\": " << nodes << ", \"tombs\": " << tombs << ", \"height\": " << height
+		<< ", \"maxDepth\": " << maxDepth << ", \"avgDepth\": " << avgDepth << ", \"balance\": {";
+	for (it = balance.begin(); it != balance.end(); ++it)
+		out << (it == balance.begin() ? "" : ", ") << '"' << it->first << "\": " << it->second;
+	out << "}, \"nodeBytes\": " << nodeBytes << ", \"rcdBytes\": " << rcdBytes
+		<< ", \"slackBytes\": " << slackBytes << ", \"farLinks\": " << farLinks << '}' << endl;
+	return out.good();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////AVL tree/////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2 = NULLT>
-class AVLTree {
-
-private :
-	Node<T1, T2> *root;
-	int size;
-	int(*cmp)(const T1 &a, const T1 &b);
-
-	int calcHeight(const Node<T1, T2> * const node) const;
-	int calcSize(const Node<T1, T2> * const node) const;
-	Node<T1, T2>* rotateLL(Node<T1, T2> *N1);
-	Node<T1, T2>* rotateRR(Node<T1, T2> *N1);
-	Node<T1, T2>* rotateLR(Node<T1, T2> *N1);
-	Node<T1, T2>* rotateRL(Node<T1, T2> *N1);
-	Node<T1, T2>* balance(Node<T1, T2> *node);
-	Node<T1, T2>* plug(Node<T1, T2> *node, const T1 &id);
-	Node<T1, T2>* cut(Node<T1, T2> *node, const T1 &id);
-	Node<T1, T2>* findRML(const Node<T1, T2>* const node) const;
+template<class T1, class T2 = NULLT, class Aug = NOAUG, class Bal = AVLBAL, class Cmp = AVLCMP<T1> >
+class AVLTree : private AVLCMPBOX<Cmp> {
+
+protected :
+	Node<T1, T2, Aug, Bal> *root;
+	Node<T1, T2, Aug, Bal> *finger;	// the last accessed node, NULL if it is deleted
+	AVLSIZE size;
+	AVLSIZE tombs;	// nodes deleted lazily, not counted in size
+	double lazy;	// the tombstone ratio that triggers compaction, 0 for eager deletes
+
+	int cmp(const T1 &a, const T1 &b) const { return this->comparator()(a, b); }
+
+	typename Bal::field_type calcHeight(const Node<T1, T2, Aug, Bal> * const node) const;
+	AVLSIZE calcSize(const Node<T1, T2, Aug, Bal> * const node) const;
+	Node<T1, T2, Aug, Bal>* rotateLL(Node<T1, T2, Aug, Bal> *N1);
+	Node<T1, T2, Aug, Bal>* rotateRR(Node<T1, T2, Aug, Bal> *N1);
+	Node<T1, T2, Aug, Bal>* rotateLR(Node<T1, T2, Aug, Bal> *N1);
+	Node<T1, T2, Aug, Bal>* rotateRL(Node<T1, T2, Aug, Bal> *N1);
+	Node<T1, T2, Aug, Bal>* balance(Node<T1, T2, Aug, Bal> *node, typename Bal::field_type old);
+	Node<T1, T2, Aug, Bal>* retrace(Node<T1, T2, Aug, Bal> *node);
+	Node<T1, T2, Aug, Bal>* climb(Node<T1, T2, Aug, Bal> *node, const T1 &id) const;
+	Node<T1, T2, Aug, Bal>* attach(Node<T1, T2, Aug, Bal> *from, const T1 &id, const T2 *rcd, bool &fresh, Node<T1, T2, Aug, Bal> *adopt = NULL);
+	Node<T1, T2, Aug, Bal>* findRML(const Node<T1, T2, Aug, Bal>* const node) const;
+	void unlink(Node<T1, T2, Aug, Bal> *node);
+	void refresh(Node<T1, T2, Aug, Bal> *node);
+	Node<T1, T2, Aug, Bal>* join(Node<T1, T2, Aug, Bal> *L, Node<T1, T2, Aug, Bal> *k, Node<T1, T2, Aug, Bal> *R);
+	Node<T1, T2, Aug, Bal>* join2(Node<T1, T2, Aug, Bal> *L, Node<T1, T2, Aug, Bal> *R);
+	void split(Node<T1, T2, Aug, Bal> *node, const T1 &id, bool upper, Node<T1, T2, Aug, Bal> *&L, Node<T1, T2, Aug, Bal> *&R);
+	AVLSIZE discard(Node<T1, T2, Aug, Bal> *node);
+	Node<T1, T2, Aug, Bal>* build(const T1 *ids, const T2 *rcds, const int *idx, int lo, int hi);
+	Node<T1, T2, Aug, Bal>* unite(Node<T1, T2, Aug, Bal> *node, const T1 *ids, const T2 *rcds, const int *idx, int lo, int hi);
+	Node<T1, T2, Aug, Bal>* differ(Node<T1, T2, Aug, Bal> *node, const T1 *ids, const int *idx, int lo, int hi);
+	int bound(const T1 &id, const T1 *ids, const int *idx, int lo, int hi) const;
+	void order(const T1 *ids, int n, vector<int> &idx) const;
+	void revive(Node<T1, T2, Aug, Bal> *node, const T2 *rcd, bool &fresh);
+	void gather(Node<T1, T2, Aug, Bal> *node, vector<Node<T1, T2, Aug, Bal> *> &live);
+	Node<T1, T2, Aug, Bal>* relink(Node<T1, T2, Aug, Bal> **nodes, AVLSIZE lo, AVLSIZE hi);
 public :
 	// constructors and destructor
 	AVLTree();
-	AVLTree(int(*compare)(const T1 &a, const T1 &b));
-	AVLTree(const Node<T1, T2> &head, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	AVLTree(const T1 &rootID, const T2 * const rootRcd = NULL, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	AVLTree(const T1 &rootID, const T2 &rootRcd, int(*compare)(const T1 &a, const T1 &b) = dCmp);
-	AVLTree(const AVLTree<T1, T2> &New);
+	AVLTree(const Cmp &compare);
+	AVLTree(const Node<T1, T2, Aug, Bal> &head, const Cmp &compare = Cmp());
+	AVLTree(const T1 &rootID, const T2 * const rootRcd = NULL, const Cmp &compare = Cmp());
+	AVLTree(const T1 &rootID, const T2 &rootRcd, const Cmp &compare = Cmp());
+	AVLTree(const AVLTree<T1, T2, Aug, Bal, Cmp> &New);
 	~AVLTree();
 
-	bool setCmp(int(*compare)(const T1 &a, const T1 &b));
+	bool setCmp(const Cmp &compare);
+	const Cmp &getCmp() const { return this->comparator(); }
 	bool addRoot(const T1 &id, const T2 * const rcd = NULL);
 	bool addRoot(const T1 &id, const T2 &rcd);
-	bool addRoot(const Node<T1, T2> &New);
+	bool addRoot(const Node<T1, T2, Aug, Bal> &New);
 
 	bool Insert(const T1 &id);
+	bool Insert(const T1 &id, const T2 &rcd);
+	bool InsertNear(const Node<T1, T2, Aug, Bal> *hint, const T1 &id);
+	bool InsertNode(Node<T1, T2, Aug, Bal> *node);
+	bool Modify(const T1 &id, const T2 &rcd);
 	bool Delete(const T1 &id);
+	int erase(const T1 &id) { return Delete(id) ? 1 : 0; }
+	Node<T1, T2, Aug, Bal> *extract(const T1 &id);
+	int insertBatch(const T1 *ids, int n);
+	int insertBatch(const T1 *ids, const T2 *rcds, int n);
+	int eraseBatch(const T1 *ids, int n);
+	AVLSIZE eraseRange(const T1 &lo, const T1 &hi);
+	bool setLazy(double ratio);
+	void compact();
 	bool empty();
 
-	int getSize() const { return size; }
-	int getHeight() const { return root->getHeight(); }
+	AVLSIZE getSize() const { return size; }
+	AVLSIZE getTombs() const { return tombs; }
+	int getHeight() const;
+	typename Bal::field_type getField() const { return root == NULL ? (typename Bal::field_type)Bal::nil : root->getHeight(); }
 	T2 *find(const T1 &id) const;
+	bool contains(const T1 &id) const { return findNode(id) != NULL; }
+	T2 *fingerFind(const T1 &id);
+	const Node<T1, T2, Aug, Bal> *findNode(const T1 &id) const;
+	const Node<T1, T2, Aug, Bal> *lowerNode(const T1 &id) const;
+	int findMany(const T1 *ids, T2 **rcds, int n) const;
+#ifdef AVL_CORO
+	AVLTASK<T2 *> coFind(T1 id) const;
+#endif
+	const Node<T1, T2, Aug, Bal> *getFinger() const { return finger; }
+	const Node<T1, T2, Aug, Bal> *getRoot() const { return root; }
+	typename Aug::value_type rangeAggregate(const T1 &lo, const T1 &hi) const;
 	T1 rootID() const { return root->getID(); }
+	AVLSTATS stats() const;
+	bool toDot(ostream &out = cout, int depth = 6) const;
 	bool print() const;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// A resumable walk over the IDs in [lo, hi] of an AVLTree, which scans or
+// erases at most a given number of nodes per step, so that a large purge can
+// be spread over many event loop ticks. It keeps the next ID rather than a
+// node between steps, so the tree may change in between.
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2 = NULLT, class Aug = NOAUG, class Bal = AVLBAL, class Cmp = AVLCMP<T1> >
+class AVLCURSOR {
+	AVLTree<T1, T2, Aug, Bal, Cmp> *tree;
+	T1 at;	// the next ID to visit, once begun
+	T1 hi;	// the last ID to visit, if bounded
+	bool begun, bounded, over;
+
+	const Node<T1, T2, Aug, Bal> *start() const;
+	bool inside(const Node<T1, T2, Aug, Bal> *node) const;
+public :
+	AVLCURSOR(AVLTree<T1, T2, Aug, Bal, Cmp> &tree);
+	AVLCURSOR(AVLTree<T1, T2, Aug, Bal, Cmp> &tree, const T1 &lo, const T1 &hi);
+
+	template<class F> AVLSIZE scan(F visit, AVLSIZE steps);
+	AVLSIZE erase(AVLSIZE steps);
+	bool done() const { return over; }
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AVLTree
 // DESCRIPTION: Constructor of AVLTree class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree() {
-	root = NULL;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree() : AVLCMPBOX<Cmp>(Cmp()) {
+	root = finger = NULL;
 	size = 0;
-	cmp = dCmp;
+	tombs = 0;
+	lazy = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AVLTree
 // DESCRIPTION: Constructor of AVLTree class.
-//   ARGUMENTS: int(*compare)(const T1 &a, const T1 &b) - the compare function
+//   ARGUMENTS: const Cmp &compare - the comparator, e.g. a compare function
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree(int(*compare)(const T1 &a, const T1 &b)) {
-	root = NULL;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree(const Cmp &compare) : AVLCMPBOX<Cmp>(compare) {
+	root = finger = NULL;
 	size = 0;
-	cmp = compare;
+	tombs = 0;
+	lazy = 0;
 }
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AVLTree
 // DESCRIPTION: Constructor of AVLTree class.
-//   ARGUMENTS: const Node<T1, T2> &head - the root node of the AVL tree
-//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> &head - the root node of the AVL tree
+//				const Cmp &compare = Cmp() - the comparator
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree(const Node<T1, T2> &head, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(head.getID(), head.getRcd());
-	size = calcSize(root);
-	cmp = compare;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree(const Node<T1, T2, Aug, Bal> &head, const Cmp &compare) : AVLCMPBOX<Cmp>(compare) {
+	root = new Node<T1, T2, Aug, Bal>(head.getID(), head.getRcd());
+	finger = NULL;
+	size = 1;
+	tombs = 0;
+	lazy = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -570,19 +1121,21 @@ AVLTree<T1, T2>::AVLTree(const Node<T1, T2> &head, int(*compare)(const T1 &a, co
 // DESCRIPTION: Constructor of AVLTree class.
 //   ARGUMENTS: const T1 &rootID - the ID of the root node
 //				const T2 * const rootRcd = NULL - the initial root record
-//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//				const Cmp &compare = Cmp() - the comparator
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree(const T1 &rootID, const T2 * const rootRcd, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(rootID, rootRcd);
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree(const T1 &rootID, const T2 * const rootRcd, const Cmp &compare) : AVLCMPBOX<Cmp>(compare) {
+	root = new Node<T1, T2, Aug, Bal>(rootID, rootRcd);
+	finger = NULL;
 	size = 1;
-	cmp = compare;
+	tombs = 0;
+	lazy = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -590,38 +1143,42 @@ AVLTree<T1, T2>::AVLTree(const T1 &rootID, const T2 * const rootRcd, int(*compar
 // DESCRIPTION: Constructor of AVLTree class.
 //   ARGUMENTS: const T1 &rootID - the ID of the root node
 //				const T2 &rootRcd - the initial root record
-//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//				const Cmp &compare = Cmp() - the comparator
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree(const T1 &rootID, const T2 &rootRcd, int(*compare)(const T1 &a, const T1 &b)) {
-	root = new Node<T1, T2>(rootID, rootRcd);
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree(const T1 &rootID, const T2 &rootRcd, const Cmp &compare) : AVLCMPBOX<Cmp>(compare) {
+	root = new Node<T1, T2, Aug, Bal>(rootID, rootRcd);
+	finger = NULL;
 	size = 1;
-	cmp = compare;
+	tombs = 0;
+	lazy = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: AVLTree
 // DESCRIPTION: Copy constructor of AVLTree class.
-//   ARGUMENTS: const AVLTree<T1, T2> &Old - the AVLTree that is to be copied
+//   ARGUMENTS: const AVLTree<T1, T2, Aug, Bal, Cmp> &Old - the AVLTree that is to be copied
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, tombs, lazy, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::AVLTree(const AVLTree<T1, T2> &Old) {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::AVLTree(const AVLTree<T1, T2, Aug, Bal, Cmp> &Old) : AVLCMPBOX<Cmp>(Old.getCmp()) {
 	size = Old.size;
-	cmp = Old.cmp;
+	tombs = Old.tombs;
+	lazy = Old.lazy;
+	root = finger = NULL;
 	if (Old.root != NULL) {
-		root = new Node<T1, T2>;
+		root = new Node<T1, T2, Aug, Bal>;
 		root->copy(Old.root);
 	}
 }
@@ -631,14 +1188,14 @@ AVLTree<T1, T2>::AVLTree(const AVLTree<T1, T2> &Old) {
 // DESCRIPTION: Destructor of AVLTree class.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size, cmp;
+// MODIFIES GL: root, finger, size, cmp;
 //     RETURNS: none
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-AVLTree<T1, T2>::~AVLTree() {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTree<T1, T2, Aug, Bal, Cmp>::~AVLTree() {
 	//cout << "Destructor: ";
 	//if (root != NULL)
 	//	cout << root->getID();
@@ -649,34 +1206,35 @@ AVLTree<T1, T2>::~AVLTree() {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: calcHeight
 // DESCRIPTION: To get the height of a node in AVL tree.
-//   ARGUMENTS: const Node<T1, T2> * const node - the node of which the height we want
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> * const node - the node of which the height we want
 // USES GLOBAL: none
 // MODIFIES GL: none
-//     RETURNS: int
+//     RETURNS: typename Bal::field_type
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-int AVLTree<T1, T2>::calcHeight(const Node<T1, T2> * const node) const {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+typename Bal::field_type AVLTree<T1, T2, Aug, Bal, Cmp>::calcHeight(const Node<T1, T2, Aug, Bal> * const node) const {
 	if (node == NULL)
-		return -1;
+		return Bal::nil;
 	return node->getHeight();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: calcSize
-// DESCRIPTION: To calculate the size of the tree with the root "node".
-//   ARGUMENTS: const Node<T1, T2> * const node - the root the of tree
+// DESCRIPTION: To calculate the size of the tree with the root "node". It
+//				visits every node, so it is only used on a copied subtree.
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> * const node - the root the of tree
 // USES GLOBAL: none
 // MODIFIES GL: none
-//     RETURNS: int
+//     RETURNS: AVLSIZE
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-int AVLTree<T1, T2>::calcSize(const Node<T1, T2> * const node) const {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLSIZE AVLTree<T1, T2, Aug, Bal, Cmp>::calcSize(const Node<T1, T2, Aug, Bal> * const node) const {
 	if (node == NULL)
 		return 0;
 	else
@@ -685,18 +1243,21 @@ int AVLTree<T1, T2>::calcSize(const Node<T1, T2> * const node) const {
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: setCmp
-// DESCRIPTION: To assign the compare function to the member function pointer.
-//   ARGUMENTS: int(*compare)(const T1 &a, const T1 &b) - the compare function
+// DESCRIPTION: To replace the comparator. The order of a tree is fixed once
+//				it has two nodes, so it is only allowed before that.
+//   ARGUMENTS: const Cmp &compare - the comparator, e.g. a compare function
 // USES GLOBAL: none
 // MODIFIES GL: cmp
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::setCmp(int(*compare)(const T1 &a, const T1 &b)) {
-	cmp = compare;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::setCmp(const Cmp &compare) {
+	if (size + tombs > 1)
+		throw AVLERR("The comparator of a populated tree cannot change");
+	this->comparator(compare);
 	return true;
 }
 
@@ -710,15 +1271,15 @@ bool AVLTree<T1, T2>::setCmp(int(*compare)(const T1 &a, const T1 &b)) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::addRoot(const T1 &id, const T2 * const rcd) {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::addRoot(const T1 &id, const T2 * const rcd) {
 	if (root != NULL) {
 		throw AVLERR("root already exists");
 	}
-	root = new Node<T1, T2>(id, rcd);
-	size = calcSize(root);
+	root = new Node<T1, T2, Aug, Bal>(id, rcd);
+	size = 1;
 	return true;
 }
 
@@ -732,35 +1293,35 @@ bool AVLTree<T1, T2>::addRoot(const T1 &id, const T2 * const rcd) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::addRoot(const T1 &id, const T2 &rcd) {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::addRoot(const T1 &id, const T2 &rcd) {
 	if (root != NULL) {
 		throw AVLERR("root already exists");
 	}
-	root = new Node<T1, T2>(id, rcd);
-	size = calcSize(root);
+	root = new Node<T1, T2, Aug, Bal>(id, rcd);
+	size = 1;
 	return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: addRoot
 // DESCRIPTION: To add a root for the AVL tree.
-//   ARGUMENTS: const Node<T1, T2> &New - the copy of the root node
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> &New - the copy of the root node
 // USES GLOBAL: none
 // MODIFIES GL: root, size
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::addRoot(const Node<T1, T2> &New) {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::addRoot(const Node<T1, T2, Aug, Bal> &New) {
 	if (root != NULL) {
 		throw AVLERR("root already exists");
 	}
-	root = new Node<T1, T2>(New);
+	root = new Node<T1, T2, Aug, Bal>(New);
 	size = calcSize(root);
 	return true;
 }
@@ -770,19 +1331,19 @@ bool AVLTree<T1, T2>::addRoot(const Node<T1, T2> &New) {
 // DESCRIPTION: To delete all the nodes in the AVL tree.
 //   ARGUMENTS: none
 // USES GLOBAL: none
-// MODIFIES GL: root, size
+// MODIFIES GL: root, size, tombs
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::empty() {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::empty() {
 	if (root == NULL)
 		return true;
 	delete root;
-	root = NULL;
-	size = 0;
+	root = finger = NULL;
+	size = tombs = 0;
 	return true;
 }
 
@@ -795,36 +1356,322 @@ bool AVLTree<T1, T2>::empty() {
 //     RETURNS: T2*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+T2 *AVLTree<T1, T2, Aug, Bal, Cmp>::find(const T1 &id) const {
+	const Node<T1, T2, Aug, Bal> *p = findNode(id);
+	if (p == NULL)
+		return NULL;
+	return p->getRcd();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: fingerFind
+// DESCRIPTION: To find a node of a certain ID starting from the last accessed
+//				node. Typically O(log d) for a target d positions away.
+//   ARGUMENTS: const T1 &id - the ID of the node that we want to find
+// USES GLOBAL: none
+// MODIFIES GL: finger
+//     RETURNS: T2*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+T2 *AVLTree<T1, T2, Aug, Bal, Cmp>::fingerFind(const T1 &id) {
+	Node<T1, T2, Aug, Bal> *p = finger != NULL ? finger : root;
+	int c;
+	if (p == NULL)
+		return NULL;
+	p = climb(p, id);
+	while (p != NULL) {
+		c = cmp(id, p->getID());
+		if (c == 0) {
+			finger = p;
+			return p->dead ? NULL : p->getRcd();
+		}
+		p = p->Son[c > 0];
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getHeight
+// DESCRIPTION: To get the height of the tree, a leaf being 0. Under AVLBAL it
+//				is the field of the root; the other policies keep a rank or
+//				a size there, so the tree is walked in O(n) without recursion.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - -1 for an empty tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::getHeight() const {
+	vector<pair<const Node<T1, T2, Aug, Bal> *, int> > stack;
+	const Node<T1, T2, Aug, Bal> *p;
+	int h = -1, d;
+	if (root == NULL)
+		return -1;
+	if (BALINFO<Bal>::height)
+		return (int)root->getHeight();
+	stack.push_back(make_pair(root, 0));
+	while (!stack.empty()) {
+		p = stack.back().first;
+		d = stack.back().second;
+		stack.pop_back();
+		h = MAX(h, d);
+		if (p->Son[0] != NULL)
+			stack.push_back(make_pair(p->Son[0], d + 1));
+		if (p->Son[1] != NULL)
+			stack.push_back(make_pair(p->Son[1], d + 1));
+	}
+	return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: findNode
+// DESCRIPTION: To find the node of a certain ID, e.g. to use it as a hint.
+//   ARGUMENTS: const T1 &id - the ID of the node that we want to find
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: const Node<T1, T2, Aug, Bal>*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+const Node<T1, T2, Aug, Bal> *AVLTree<T1, T2, Aug, Bal, Cmp>::findNode(const T1 &id) const {
+	Node<T1, T2, Aug, Bal> *p = root;
+	int c;
+	while (p != NULL) {
+#ifdef AVL_PREFETCH
+		if (p->Son[0] != NULL) {
+			AVL_PF(p->Son[0]->Son[0]);
+			AVL_PF(p->Son[0]->Son[1]);
+		}
+		if (p->Son[1] != NULL) {
+			AVL_PF(p->Son[1]->Son[0]);
+			AVL_PF(p->Son[1]->Son[1]);
+		}
+#endif
+		c = cmp(id, p->getID());
+		if (c == 0)
+			return p->dead ? NULL : p;
+		p = p->Son[c > 0];
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: lowerNode
+// DESCRIPTION: To find the first live node whose ID is not less than id.
+//   ARGUMENTS: const T1 &id - the lower bound of the ID
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: const Node<T1, T2, Aug, Bal>* - NULL if all IDs are less
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+const Node<T1, T2, Aug, Bal> *AVLTree<T1, T2, Aug, Bal, Cmp>::lowerNode(const T1 &id) const {
+	Node<T1, T2, Aug, Bal> *p = root, *best = NULL;
+	int c;
+	while (p != NULL) {
+		c = cmp(id, p->getID());
+		if (c <= 0)
+			best = p;
+		if (c == 0)
+			break;
+		p = p->Son[c > 0];
+	}
+	if (best != NULL && best->dead)
+		best = best->next();
+	return best;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: findMany
+// DESCRIPTION: To find the records of many independent IDs. The descents run
+//				in groups in lockstep, and each step prefetches the next node,
+//				so the cache misses of one lookup overlap with the others.
+//   ARGUMENTS: const T1 *ids - the IDs that we want to find
+//				T2 **rcds - receives the record of every ID, NULL if not found
+//				int n - the number of IDs
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - the number of IDs found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::findMany(const T1 *ids, T2 **rcds, int n) const {
+	const int G = 16;	// lookups in flight
+	Node<T1, T2, Aug, Bal> *cur[G], *p;
+	int found = 0, m, live, i, c;
+	for (int base = 0; base < n; base += G) {
+		m = n - base < G ? n - base : G;
+		for (i = 0; i < m; i++) {
+			cur[i] = root;
+			rcds[base + i] = NULL;
+		}
+		live = root != NULL ? m : 0;
+		while (live > 0) {
+			live = 0;
+			for (i = 0; i < m; i++) {
+				if ((p = cur[i]) == NULL)
+					continue;
+				c = cmp(ids[base + i], p->ID);
+				if (c == 0) {
+					if (!p->dead) {
+						rcds[base + i] = p->getRcd();
+						++found;
+					}
+					cur[i] = NULL;
+					continue;
+				}
+				cur[i] = p = p->Son[c > 0];
+				if (p != NULL) {
+					AVL_PF(p);
+					++live;
+				}
+			}
+		}
+	}
+	return found;
+}
+
+#ifdef AVL_CORO
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: coFind
+// DESCRIPTION: To find the record of an ID as a coroutine: every step down
+//				prefetches the next node and suspends, and the scheduler runs
+//				other lookups while it is loaded. The ID is taken by value as
+//				the coroutine outlives the caller's expression. The tree must
+//				not change until the lookup is done.
+//   ARGUMENTS: T1 id - the ID that we want to find
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLTASK<T2 *> - gives the record, NULL if not found, once done
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLTASK<T2 *> AVLTree<T1, T2, Aug, Bal, Cmp>::coFind(T1 id) const {
+	Node<T1, T2, Aug, Bal> *p = root;
+	int c;
+	while (p != NULL) {
+		c = cmp(id, p->ID);
+		if (c == 0)
+			co_return p->dead ? NULL : p->getRcd();
+		p = p->Son[c > 0];
+		if (p != NULL) {
+			AVL_PF(p);
+			co_await std::suspend_always();
+		}
+	}
+	co_return NULL;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-T2 *AVLTree<T1, T2>::find(const T1 &id) const {
-	Node<T1, T2> *p = root;
-	while ((p != NULL) && (cmp(p->getID(), id) != 0)) {
-		if (cmp(id, p->getID()) > 0)
+//        NAME: Modify
+// DESCRIPTION: To replace the record of a node and refresh the augmentation on
+//				its path. Records changed through find() bypass the augmentation.
+//   ARGUMENTS: const T1 &id - the ID of the node
+//				const T2 &rcd - the new record
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - false if the node is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::Modify(const T1 &id, const T2 &rcd) {
+	Node<T1, T2, Aug, Bal> *p = const_cast<Node<T1, T2, Aug, Bal> *>(findNode(id));
+	if (p == NULL)
+		return false;
+	p->setRcd(&rcd);
+	refresh(p);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: rangeAggregate
+// DESCRIPTION: To fold the augmentation over the nodes with lo <= ID <= hi in
+//				O(log n), following the two boundary paths.
+//   ARGUMENTS: const T1 &lo - the lower bound of the IDs
+//				const T1 &hi - the upper bound of the IDs
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: typename Aug::value_type
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+typename Aug::value_type AVLTree<T1, T2, Aug, Bal, Cmp>::rangeAggregate(const T1 &lo, const T1 &hi) const {
+	typename Aug::value_type lAcc = Aug::identity(), rAcc = Aug::identity();
+	Node<T1, T2, Aug, Bal> *p = root, *q;
+
+	// find the top node inside [lo, hi]
+	while (p != NULL) {
+		if (cmp(p->getID(), lo) < 0)
 			p = p->getRgt();
-		else
+		else if (cmp(p->getID(), hi) > 0)
 			p = p->getLft();
+		else
+			break;
 	}
 	if (p == NULL)
-		return NULL;
-	return p->getRcd();
+		return Aug::identity();
+
+	// left boundary: a node >= lo brings its right subtree along
+	for (q = p->getLft(); q != NULL; ) {
+		if (cmp(q->getID(), lo) >= 0) {
+			lAcc = Aug::combine(q->own(),
+				Aug::combine(q->getRgt() != NULL ? q->getRgt()->getAgg() : Aug::identity(), lAcc));
+			q = q->getLft();
+		}
+		else
+			q = q->getRgt();
+	}
+
+	// right boundary: a node <= hi brings its left subtree along
+	for (q = p->getRgt(); q != NULL; ) {
+		if (cmp(q->getID(), hi) <= 0) {
+			rAcc = Aug::combine(Aug::combine(rAcc,
+				q->getLft() != NULL ? q->getLft()->getAgg() : Aug::identity()), q->own());
+			q = q->getRgt();
+		}
+		else
+			q = q->getLft();
+	}
+
+	return Aug::combine(Aug::combine(lAcc, p->own()), rAcc);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: rotateLL
 // DESCRIPTION: The single rotation LL of AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the trouble finder node
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *N1 - the trouble finder node
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::rotateLL(Node<T1, T2> *N1) {
-	Node<T1, T2> *N2 = N1->getLft();
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::rotateLL(Node<T1, T2, Aug, Bal> *N1) {
+	Node<T1, T2, Aug, Bal> *N2 = N1->getLft();
 	N1->AddLft(N2->getRgt());
 	N2->AddRgt(N1);
 	return N2;
@@ -833,17 +1680,17 @@ Node<T1, T2>* AVLTree<T1, T2>::rotateLL(Node<T1, T2> *N1) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: rotateRR
 // DESCRIPTION: The single rotation RR of AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the trouble finder node
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *N1 - the trouble finder node
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::rotateRR(Node<T1, T2> *N1) {
-	Node<T1, T2> *N2 = N1->getRgt();
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::rotateRR(Node<T1, T2, Aug, Bal> *N1) {
+	Node<T1, T2, Aug, Bal> *N2 = N1->getRgt();
 	N1->AddRgt(N2->getLft());
 	N2->AddLft(N1);
 	return N2;
@@ -852,18 +1699,18 @@ Node<T1, T2>* AVLTree<T1, T2>::rotateRR(Node<T1, T2> *N1) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: rotateLR
 // DESCRIPTION: The single rotation LR of AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the trouble finder node
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *N1 - the trouble finder node
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::rotateLR(Node<T1, T2> *N1) {
-	Node<T1, T2> *N2 = N1->getLft();
-	Node<T1, T2> *N3 = N2->getRgt();
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::rotateLR(Node<T1, T2, Aug, Bal> *N1) {
+	Node<T1, T2, Aug, Bal> *N2 = N1->getLft();
+	Node<T1, T2, Aug, Bal> *N3 = N2->getRgt();
 	N2->AddRgt(N3->getLft());
 	N1->AddLft(N3->getRgt());
 	N3->AddLft(N2);
@@ -874,18 +1721,18 @@ Node<T1, T2>* AVLTree<T1, T2>::rotateLR(Node<T1, T2> *N1) {
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: rotateRL
 // DESCRIPTION: The single rotation RL of AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the trouble finder node
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *N1 - the trouble finder node
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::rotateRL(Node<T1, T2> *N1) {
-	Node<T1, T2> *N2 = N1->getRgt();
-	Node<T1, T2> *N3 = N2->getLft();
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::rotateRL(Node<T1, T2, Aug, Bal> *N1) {
+	Node<T1, T2, Aug, Bal> *N2 = N1->getRgt();
+	Node<T1, T2, Aug, Bal> *N3 = N2->getLft();
 	N2->AddLft(N3->getRgt());
 	N1->AddRgt(N3->getLft());
 	N3->AddLft(N1);
@@ -895,63 +1742,163 @@ Node<T1, T2>* AVLTree<T1, T2>::rotateRL(Node<T1, T2> *N1) {
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: balance
-// DESCRIPTION: To balance a subtree whose root is "node".
-//   ARGUMENTS: Node<T1, T2> *node - the root of the sub tree
+// DESCRIPTION: To balance a subtree whose root is "node", doing the rotation
+//				that the balance policy asks for.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the sub tree
+//				typename Bal::field_type old - the balance field of node before its sons changed
 // USES GLOBAL: none
 // MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-12
-//							KC 2015-02-12
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::balance(Node<T1, T2> *node) {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::balance(Node<T1, T2, Aug, Bal> *node, typename Bal::field_type old) {
 	if (node == NULL)
 		return node;
 
-	if (calcHeight(node->getLft()) - calcHeight(node->getRgt()) >= 2) {
-		if (calcHeight(node->getLft()->getLft()) > calcHeight(node->getLft()->getRgt()))
-			node = this->rotateLL(node);
-		else
-			node = this->rotateLR(node);
+	switch (Bal::pick(node, old)) {
+	case BALLL:
+		return this->rotateLL(node);
+	case BALLR:
+		return this->rotateLR(node);
+	case BALRR:
+		return this->rotateRR(node);
+	case BALRL:
+		return this->rotateRL(node);
+	default:
+		return node;
 	}
-	else if (calcHeight(node->getRgt()) - calcHeight(node->getLft()) >= 2) {
-		if (calcHeight(node->getRgt()->getRgt()) > calcHeight(node->getRgt()->getLft()))
-			node = this->rotateRR(node);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: retrace
+// DESCRIPTION: To rebalance bottom-up from "node" to the root, stopping as soon
+//				as a subtree keeps its balance field (its height in AVL) unless
+//				there is an augmentation.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the lowest node whose sons have changed
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the new top if the walk reached it, NULL otherwise
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::retrace(Node<T1, T2, Aug, Bal> *node) {
+	Node<T1, T2, Aug, Bal> *par, *sub;
+	typename Bal::field_type old;
+	while (node != NULL) {
+		par = node->Par;
+		old = node->height;
+		node->update();
+		sub = balance(node, old);
+		sub->Par = par;
+		if (par == NULL)
+			return sub;
+		if (par->Son[0] == node)
+			par->Son[0] = sub;
 		else
-			node = this->rotateRL(node);
+			par->Son[1] = sub;
+		if (sub->height == old && AUGINFO<Aug>::none)
+			return NULL;
+		node = par;
 	}
-
-	return node;
+	return NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: plug
-// DESCRIPTION: plug a node into the AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the root of the subtree that contains the new node
-//				const T1 &id - the id of the new node that is to be plugged in
+//        NAME: climb
+// DESCRIPTION: To walk up from "node" to the lowest ancestor whose subtree covers
+//				"id". Only the ancestors bounding the subtree are compared.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the start of the finger search
+//				const T1 &id - the id that is searched for
 // USES GLOBAL: none
-// MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::climb(Node<T1, T2, Aug, Bal> *node, const T1 &id) const {
+	Node<T1, T2, Aug, Bal> *q;
+	int c, d;
+	c = cmp(id, node->getID());
+	if (c == 0)
+		return node;
+	while (true) {
+		// ancestors reached from the same side bound nothing new
+		q = node;
+		while (q->Par != NULL && q->Par->Son[c > 0] == q)
+			q = q->Par;
+		q = q->Par;
+		if (q == NULL)
+			return node;
+		d = cmp(id, q->getID());
+		if (d == 0 || (d > 0) != (c > 0))
+			return d == 0 ? q : node;
+		node = q;
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::plug(Node<T1, T2> *node, const T1 &id) {
-	if (node == NULL) {
-		node = new Node<T1, T2>(id);
-		++size;
+//        NAME: attach
+// DESCRIPTION: To descend from "from" and hang a new leaf with ID "id" if the
+//				id is not in the tree yet.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *from - the root of the subtree that covers id
+//				const T1 &id - the id of the new node
+//				const T2 *rcd - the record of the new node, NULL for default
+//				bool &fresh - set to whether a new node has been hung
+//				Node<T1, T2, Aug, Bal> *adopt - a detached node with ID "id" to be
+//					hung instead of allocating one, NULL for none
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, tombs
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the node with ID "id"
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::attach(Node<T1, T2, Aug, Bal> *from, const T1 &id, const T2 *rcd, bool &fresh, Node<T1, T2, Aug, Bal> *adopt) {
+	Node<T1, T2, Aug, Bal> *p = from, *par = NULL, *top;
+	int c = 0;
+	fresh = false;
+	while (p != NULL) {
+		c = cmp(id, p->getID());
+		if (c == 0) {
+			if (p->dead) {
+				revive(p, adopt != NULL ? adopt->getRcd() : rcd, fresh);
+				refresh(p);
+			}
+			if (adopt != NULL && fresh)
+				delete adopt;	// its record lives on in the tombstone
+			finger = p;
+			return p;
+		}
+		par = p;
+		p = p->Son[c > 0];
 	}
-	else if (cmp(id, node->getID()) > 0) {
-		node->AddRgt(this->plug(node->getRgt(), id));
-		node = balance(node);
+	if (adopt != NULL) {
+		p = adopt;
+		p->update();
 	}
-	else if (cmp(id, node->getID()) < 0) {
-		node->AddLft(this->plug(node->getLft(), id));
-		node = balance(node);
+	else
+		p = new Node<T1, T2, Aug, Bal>(id, rcd);
+	++size;
+	fresh = true;
+	finger = p;
+	if (par == NULL) {
+		root = p;
+		return p;
 	}
-	return node;
+	p->Par = par;
+	par->Son[c > 0] = p;
+	top = retrace(par);
+	if (top != NULL)
+		root = top;
+	return p;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -959,32 +1906,104 @@ Node<T1, T2>* AVLTree<T1, T2>::plug(Node<T1, T2> *node, const T1 &id) {
 // DESCRIPTION: The user interface of inserting a node into the AVL tree.
 //   ARGUMENTS: const T1 &id - the id of the new node that is to be inserted
 // USES GLOBAL: none
-// MODIFIES GL: root (possible)
-//     RETURNS: bool
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool - false if the id is in the tree already
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::Insert(const T1 &id) {
-	root = plug(root, id);
-	return true;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::Insert(const T1 &id) {
+	bool fresh;
+	attach(root, id, NULL, fresh);
+	return fresh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a new node with its record into the AVL tree. Nothing
+//				happens if the id exists already.
+//   ARGUMENTS: const T1 &id - the id of the new node that is to be inserted
+//				const T2 &rcd - the record of the new node
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool - false if the id is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::Insert(const T1 &id, const T2 &rcd) {
+	bool fresh;
+	attach(root, id, &rcd, fresh);
+	return fresh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: InsertNear
+// DESCRIPTION: To insert a node starting from a nearby node instead of the root.
+//				Sequential inserts through the finger cost O(1) comparisons.
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> *hint - a node of this tree close to id, or
+//					NULL for the last accessed node
+//				const T1 &id - the id of the new node that is to be inserted
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool - false if the id is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::InsertNear(const Node<T1, T2, Aug, Bal> *hint, const T1 &id) {
+	Node<T1, T2, Aug, Bal> *from = const_cast<Node<T1, T2, Aug, Bal> *>(hint);
+	bool fresh;
+	if (from == NULL)
+		from = finger;
+	if (from == NULL)
+		from = root;
+	if (from != NULL)
+		from = climb(from, id);
+	attach(from, id, NULL, fresh);
+	return fresh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: InsertNode
+// DESCRIPTION: To hang a detached node, e.g. one from extract, into the AVL
+//				tree without allocating. The tree owns the node on success,
+//				and frees it if a tombstone of the same id takes its record;
+//				otherwise it stays with the caller.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the detached node with no sons
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool - false if the node's id is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::InsertNode(Node<T1, T2, Aug, Bal> *node) {
+	bool fresh;
+	if (node == NULL || node->Son[0] != NULL || node->Son[1] != NULL || node->Par != NULL)
+		throw AVLERR("node is not detached");
+	attach(root, node->ID, NULL, fresh, node);
+	return fresh;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 //        NAME: findRML
 // DESCRIPTION: To find the rightmost posterity of a node in its left sub-tree.
-//   ARGUMENTS: Node<T1, T2>* node - the top node
+//   ARGUMENTS: Node<T1, T2, Aug, Bal>* node - the top node
 // USES GLOBAL: none
 // MODIFIES GL: none
-//     RETURNS: Node<T1, T2>*
+//     RETURNS: Node<T1, T2, Aug, Bal>*
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-11
-//							KC 2015-02-11
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::findRML(const Node<T1, T2>* const node) const{
-	Node<T1, T2>* RML = node->getLft();
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::findRML(const Node<T1, T2, Aug, Bal>* const node) const{
+	Node<T1, T2, Aug, Bal>* RML = node->getLft();
 	if (RML == NULL)
 		return NULL;
 	while (RML->getRgt() != NULL)
@@ -993,78 +2012,821 @@ Node<T1, T2>* AVLTree<T1, T2>::findRML(const Node<T1, T2>* const node) const{
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: cut
-// DESCRIPTION: To cut a Node from the AVL tree.
-//   ARGUMENTS: Node<T1, T2> *N1 - the root of the subtree that node is deleted from
-//				const T1 &id - the id of the new node that is to be deleted
+//        NAME: unlink
+// DESCRIPTION: To take a Node out of the AVL tree. A node with two sons is
+//				replaced by the rightmost node of its left subtree, which is
+//				moved rather than copied, so other nodes stay where they are.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the node that is to be taken out
 // USES GLOBAL: none
-// MODIFIES GL: root (possible)
-//     RETURNS: Node<T1, T2>*
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::unlink(Node<T1, T2, Aug, Bal> *node) {
+	Node<T1, T2, Aug, Bal> *par = node->Par, *sub, *start, *top;
+
+	if (node->Son[0] != NULL && node->Son[1] != NULL) {
+		sub = findRML(node);
+		if (sub == node->Son[0])
+			start = sub;
+		else {
+			start = sub->Par;
+			start->Son[1] = sub->Son[0];
+			if (sub->Son[0] != NULL)
+				sub->Son[0]->Par = start;
+			sub->Son[0] = node->Son[0];
+			sub->Son[0]->Par = sub;
+		}
+		sub->Son[1] = node->Son[1];
+		sub->Son[1]->Par = sub;
+		sub->height = node->height;	// it takes the place of node
+	}
+	else {
+		sub = node->Son[0] != NULL ? node->Son[0] : node->Son[1];
+		start = par;
+	}
+
+	if (sub != NULL)
+		sub->Par = par;
+	if (par == NULL)
+		root = sub;
+	else if (par->Son[0] == node)
+		par->Son[0] = sub;
+	else
+		par->Son[1] = sub;
+	top = retrace(start);
+	if (top != NULL)
+		root = top;
+
+	node->Son[0] = node->Son[1] = node->Par = NULL;
+	node->height = Bal::field(Bal::nil, Bal::nil, 0);
+	--size;
+	if (finger == node)
+		finger = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: refresh
+// DESCRIPTION: To recompute the augmentation from a node up to the root after
+//				its record has changed.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the node whose record has changed
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::refresh(Node<T1, T2, Aug, Bal> *node) {
+	if (AUGINFO<Aug>::none)
+		return;
+	for (; node != NULL; node = node->Par)
+		node->update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: The user interface of deleting a node into the AVL tree. In
+//				lazy mode the node is only marked as a tombstone, and the tree
+//				is compacted once the tombstones pass the set ratio.
+//   ARGUMENTS: const T1 &id - the id of the new node that is to be deleted
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, tombs
+//     RETURNS: bool - false if the id is not in the tree
 //      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-12
-//							KC 2015-02-12
+// AUTHOR/DATE: KC 2015-02-10
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-Node<T1, T2>* AVLTree<T1, T2>::cut(Node<T1, T2> *node, const T1 &id) {
-	Node<T1, T2> *tmp;
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::Delete(const T1 &id) {
+	Node<T1, T2, Aug, Bal> *node = const_cast<Node<T1, T2, Aug, Bal> *>(findNode(id));
 	if (node == NULL)
-		return node;
-	if (cmp(id, node->getID()) > 0) {
-		tmp = cut(node->getRgt(), id);
-		if (tmp == NULL)
-			delete node->getRgt();
-		node->AddRgt(tmp);
-		node = balance(node);
+		return false;
+	if (lazy > 0) {
+		node->dead = true;
+		--size;
+		++tombs;
+		refresh(node);
+		if (tombs > lazy * (size + tombs))
+			compact();
+		return true;
 	}
-	else if (cmp(id, node->getID()) < 0) {
-		tmp = cut(node->getLft(), id);
-		if (tmp == NULL)
-			delete node->getLft();
-		node->AddLft(tmp);
-		node = balance(node);
+	unlink(node);
+	delete node;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: revive
+// DESCRIPTION: To bring a tombstone back to life with a new record. The
+//				augmentation on its path is left to the caller.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the tombstone
+//				const T2 *rcd - the new record, NULL for default
+//				bool &fresh - set to true
+// USES GLOBAL: none
+// MODIFIES GL: size, tombs
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::revive(Node<T1, T2, Aug, Bal> *node, const T2 *rcd, bool &fresh) {
+	T2 blank = T2();
+	node->setRcd(rcd != NULL ? rcd : &blank);
+	node->dead = false;
+	--tombs;
+	++size;
+	fresh = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: setLazy
+// DESCRIPTION: To switch lazy deletion on or off. Lazy deletes only mark the
+//				node, and the tree is rebuilt in linear time once the
+//				tombstones make up more than "ratio" of its nodes.
+//   ARGUMENTS: double ratio - the tombstone ratio in (0, 1] that triggers
+//					compaction, 0 for eager deletes
+// USES GLOBAL: none
+// MODIFIES GL: lazy, root, finger, tombs
+//     RETURNS: bool - false if ratio is out of range
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::setLazy(double ratio) {
+	if (ratio < 0 || ratio > 1)
+		return false;
+	lazy = ratio;
+	if (lazy == 0)
+		compact();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: compact
+// DESCRIPTION: To free all the tombstones and rebuild the rest into a balanced
+//				tree in linear time, reusing the live nodes.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, finger, tombs
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::compact() {
+	vector<Node<T1, T2, Aug, Bal> *> live;
+	if (tombs == 0)
+		return;
+	live.reserve(size);
+	gather(root, live);
+	root = live.empty() ? NULL : relink(&live[0], 0, (AVLSIZE)live.size());
+	if (root != NULL)
+		root->Par = NULL;
+	finger = NULL;
+	tombs = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: gather
+// DESCRIPTION: To collect the live nodes of a subtree inorderly, freeing the
+//				tombstones on the way.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the subtree
+//				vector<Node<T1, T2, Aug, Bal> *> &live - receives the live nodes
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::gather(Node<T1, T2, Aug, Bal> *node, vector<Node<T1, T2, Aug, Bal> *> &live) {
+	Node<T1, T2, Aug, Bal> *rgt;
+	if (node == NULL)
+		return;
+	gather(node->Son[0], live);
+	rgt = node->Son[1];
+	if (node->dead) {
+		node->Son[0] = node->Son[1] = NULL;
+		delete node;
 	}
+	else
+		live.push_back(node);
+	gather(rgt, live);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: relink
+// DESCRIPTION: To link sorted detached nodes into a balanced tree.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> **nodes - the nodes in order
+//				AVLSIZE lo, AVLSIZE hi - the range [lo, hi) of nodes to link
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the root of the new tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::relink(Node<T1, T2, Aug, Bal> **nodes, AVLSIZE lo, AVLSIZE hi) {
+	Node<T1, T2, Aug, Bal> *node;
+	AVLSIZE mid;
+	if (lo >= hi)
+		return NULL;
+	mid = lo + (hi - lo) / 2;
+	node = nodes[mid];
+	node->Son[0] = node->Son[1] = NULL;
+	node->height = Bal::field(Bal::nil, Bal::nil, 0);	// a leaf until its sons are added
+	node->AddLft(relink(nodes, lo, mid));
+	node->AddRgt(relink(nodes, mid + 1, hi));
+	return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: extract
+// DESCRIPTION: To take a node out of the AVL tree and hand it to the caller
+//				with its ID and record, in a single descent. The node can be
+//				put into a tree again by InsertNode, or be deleted.
+//   ARGUMENTS: const T1 &id - the id of the node that is to be taken out
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the detached node, NULL if not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal> *AVLTree<T1, T2, Aug, Bal, Cmp>::extract(const T1 &id) {
+	Node<T1, T2, Aug, Bal> *node = const_cast<Node<T1, T2, Aug, Bal> *>(findNode(id));
+	if (node != NULL)
+		unlink(node);
+	return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: join
+// DESCRIPTION: To join two detached subtrees with a middle node, all IDs in L
+//				being less than k's and all in R greater. The smaller subtree
+//				hangs where the spine of the bigger one is no longer heavier
+//				than it by the balance policy, and the rest is rebalanced
+//				bottom-up, costing O(|h(L) - h(R)| + 1).
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *L - the left subtree, may be NULL
+//				Node<T1, T2, Aug, Bal> *k - the middle node, without sons
+//				Node<T1, T2, Aug, Bal> *R - the right subtree, may be NULL
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the root of the joined tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::join(Node<T1, T2, Aug, Bal> *L, Node<T1, T2, Aug, Bal> *k, Node<T1, T2, Aug, Bal> *R) {
+	Node<T1, T2, Aug, Bal> *p, *top;
+	typename Bal::field_type hl = calcHeight(L), hr = calcHeight(R);
+
+	k->height = Bal::field(Bal::nil, Bal::nil, 0);	// a leaf until its sons are added
+	if (Bal::heavier(hl, hr)) {
+		for (p = L; Bal::heavier(calcHeight(p->Son[1]), hr); p = p->Son[1])
+			;
+		k->AddLft(p->Son[1]);
+		k->AddRgt(R);
+		p->Son[1] = k;
+		k->Par = p;
+		top = retrace(p);
+		return top != NULL ? top : L;
+	}
+	if (Bal::heavier(hr, hl)) {
+		for (p = R; Bal::heavier(calcHeight(p->Son[0]), hl); p = p->Son[0])
+			;
+		k->AddRgt(p->Son[0]);
+		k->AddLft(L);
+		p->Son[0] = k;
+		k->Par = p;
+		top = retrace(p);
+		return top != NULL ? top : R;
+	}
+	k->AddLft(L);
+	k->AddRgt(R);
+	k->Par = NULL;
+	return k;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: join2
+// DESCRIPTION: To join two detached subtrees, all IDs in L being less than all
+//				in R, by pulling the largest node out of L as the middle.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *L - the left subtree, may be NULL
+//				Node<T1, T2, Aug, Bal> *R - the right subtree, may be NULL
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the root of the joined tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::join2(Node<T1, T2, Aug, Bal> *L, Node<T1, T2, Aug, Bal> *R) {
+	Node<T1, T2, Aug, Bal> *mid, *rest, *top;
+	if (L == NULL)
+		return R;
+	if (R == NULL)
+		return L;
+	for (mid = L; mid->Son[1] != NULL; mid = mid->Son[1])
+		;
+	if (mid->Par == NULL)
+		rest = mid->Son[0];
 	else {
-		int Case;
-		Case = 2 * (node->getLft() != NULL) + (node->getRgt() != NULL);
+		mid->Par->Son[1] = mid->Son[0];
+		if (mid->Son[0] != NULL)
+			mid->Son[0]->Par = mid->Par;
+		top = retrace(mid->Par);
+		rest = top != NULL ? top : L;
+	}
+	if (rest != NULL)
+		rest->Par = NULL;
+	mid->Son[0] = mid->Par = NULL;
+	return join(rest, mid, R);
+}
 
-		switch (Case) {
-		case 0 :	// node is a leaf
-			return NULL;
-		case 1 :	// node has no left son
-			*node = *(node->getRgt());
-			delete node->getRgt();
-			node->AddRgt(NULL);
-			node = balance(node);
-			break;
-		default :	// node has a left son, or has both left and right subtree
-			Node<T1, T2> *RML = findRML(node);
-			*node = *RML;
-			tmp = cut(node->getLft(), RML->getID());
-			if (tmp == NULL)
-				delete node->getLft();
-			node->AddLft(tmp);
-			node = balance(node);
-			break;
-		}
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: split
+// DESCRIPTION: To split a detached subtree by an ID. Each node on the search
+//				path is joined with the pieces below it, and as the heights of
+//				the pieces telescope, the whole split costs O(log n).
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the subtree
+//				const T1 &id - the ID to split at
+//				bool upper - whether a node equal to id goes to L
+//				Node<T1, T2, Aug, Bal> *&L - receives the nodes less than id
+//				Node<T1, T2, Aug, Bal> *&R - receives the rest
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::split(Node<T1, T2, Aug, Bal> *node, const T1 &id, bool upper, Node<T1, T2, Aug, Bal> *&L, Node<T1, T2, Aug, Bal> *&R) {
+	Node<T1, T2, Aug, Bal> *lft, *rgt;
+	int c;
+	if (node == NULL) {
+		L = R = NULL;
+		return;
+	}
+	lft = node->Son[0];
+	rgt = node->Son[1];
+	node->Son[0] = node->Son[1] = NULL;
+	if (lft != NULL)
+		lft->Par = NULL;
+	if (rgt != NULL)
+		rgt->Par = NULL;
+	c = cmp(node->ID, id);
+	if (c < 0 || (upper && c == 0)) {
+		split(rgt, id, upper, rgt, R);
+		L = join(lft, node, rgt);
 	}
+	else {
+		split(lft, id, upper, L, lft);
+		R = join(lft, node, rgt);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: discard
+// DESCRIPTION: To free a detached subtree without recursion or rebalancing.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the subtree
+// USES GLOBAL: none
+// MODIFIES GL: size, tombs
+//     RETURNS: AVLSIZE - the number of live nodes freed
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLSIZE AVLTree<T1, T2, Aug, Bal, Cmp>::discard(Node<T1, T2, Aug, Bal> *node) {
+	vector<Node<T1, T2, Aug, Bal> *> stack;
+	AVLSIZE live = 0;
+	if (node != NULL)
+		stack.push_back(node);
+	while (!stack.empty()) {
+		node = stack.back();
+		stack.pop_back();
+		if (node->Son[0] != NULL)
+			stack.push_back(node->Son[0]);
+		if (node->Son[1] != NULL)
+			stack.push_back(node->Son[1]);
+		node->Son[0] = node->Son[1] = NULL;	// or the destructor frees them again
+		if (node->dead)
+			--tombs;
+		else
+			++live;
+		delete node;
+	}
+	size -= live;
+	return live;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: order
+// DESCRIPTION: To sort a batch of IDs by index, keeping the first of equal IDs.
+//   ARGUMENTS: const T1 *ids - the batch
+//				int n - the size of the batch
+//				vector<int> &idx - the sorted distinct indices
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+void AVLTree<T1, T2, Aug, Bal, Cmp>::order(const T1 *ids, int n, vector<int> &idx) const {
+	int i, m;
+	idx.resize(n);
+	for (i = 0; i < n; i++)
+		idx[i] = i;
+	stable_sort(idx.begin(), idx.end(), [this, ids](int a, int b) { return cmp(ids[a], ids[b]) < 0; });
+	for (i = m = 0; i < n; i++)
+		if (m == 0 || cmp(ids[idx[m - 1]], ids[idx[i]]) != 0)
+			idx[m++] = idx[i];
+	idx.resize(m);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: bound
+// DESCRIPTION: To find the first position in a sorted batch not less than id.
+//   ARGUMENTS: const T1 &id - the id that splits the batch
+//				const T1 *ids, const int *idx - the batch and its sorted indices
+//				int lo, int hi - the part of idx to search
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::bound(const T1 &id, const T1 *ids, const int *idx, int lo, int hi) const {
+	int mid;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (cmp(ids[idx[mid]], id) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: build
+// DESCRIPTION: To build a perfectly balanced subtree from a sorted batch.
+//   ARGUMENTS: const T1 *ids, const T2 *rcds, const int *idx - the batch, its
+//					records (may be NULL) and its sorted indices
+//				int lo, int hi - the part of idx to build from
+// USES GLOBAL: none
+// MODIFIES GL: size
+//     RETURNS: Node<T1, T2, Aug, Bal>*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::build(const T1 *ids, const T2 *rcds, const int *idx, int lo, int hi) {
+	Node<T1, T2, Aug, Bal> *node;
+	int mid;
+	if (lo >= hi)
+		return NULL;
+	mid = lo + (hi - lo) / 2;
+	node = new Node<T1, T2, Aug, Bal>(ids[idx[mid]], rcds != NULL ? rcds + idx[mid] : NULL);
+	++size;
+	node->AddLft(build(ids, rcds, idx, lo, mid));
+	node->AddRgt(build(ids, rcds, idx, mid + 1, hi));
 	return node;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-//        NAME: Delete
-// DESCRIPTION: The user interface of deleting a node into the AVL tree.
-//   ARGUMENTS: const T1 &id - the id of the new node that is to be deleted
+//        NAME: unite
+// DESCRIPTION: To insert a sorted batch into a detached subtree. The batch is
+//				split at every node on the way down, and each touched node is
+//				joined back once with its two new subtrees.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the subtree
+//				const T1 *ids, const T2 *rcds, const int *idx - the batch, its
+//					records (may be NULL) and its sorted indices
+//				int lo, int hi - the part of idx that belongs to this subtree
 // USES GLOBAL: none
-// MODIFIES GL: root (possible)
-//     RETURNS: bool
-//      AUTHOR: Kingston Chan
-// AUTHOR/DATE: KC 2015-02-10
-//							KC 2015-02-10
+// MODIFIES GL: size
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the new root of the subtree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::unite(Node<T1, T2, Aug, Bal> *node, const T1 *ids, const T2 *rcds, const int *idx, int lo, int hi) {
+	Node<T1, T2, Aug, Bal> *L, *R;
+	int m1, m2;
+	if (lo >= hi)
+		return node;
+	if (node == NULL)
+		return build(ids, rcds, idx, lo, hi);
+
+	m1 = m2 = bound(node->ID, ids, idx, lo, hi);
+	if (m2 < hi && cmp(ids[idx[m2]], node->ID) == 0) {
+		if (node->dead) {
+			bool fresh;
+			revive(node, rcds != NULL ? rcds + idx[m2] : NULL, fresh);
+		}
+		++m2;	// already in the tree
+	}
+	L = node->Son[0];
+	R = node->Son[1];
+	node->Son[0] = node->Son[1] = NULL;
+	if (L != NULL)
+		L->Par = NULL;
+	if (R != NULL)
+		R->Par = NULL;
+	L = unite(L, ids, rcds, idx, lo, m1);
+	R = unite(R, ids, rcds, idx, m2, hi);
+	return join(L, node, R);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::Delete(const T1 &id) {
-	root = cut(root, id);
-	return true;
+//        NAME: differ
+// DESCRIPTION: To delete a sorted batch from a detached subtree, splitting the
+//				batch at every node on the way down.
+//   ARGUMENTS: Node<T1, T2, Aug, Bal> *node - the root of the subtree
+//				const T1 *ids, const int *idx - the batch and its sorted indices
+//				int lo, int hi - the part of idx that belongs to this subtree
+// USES GLOBAL: none
+// MODIFIES GL: size
+//     RETURNS: Node<T1, T2, Aug, Bal>* - the new root of the subtree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+Node<T1, T2, Aug, Bal>* AVLTree<T1, T2, Aug, Bal, Cmp>::differ(Node<T1, T2, Aug, Bal> *node, const T1 *ids, const int *idx, int lo, int hi) {
+	Node<T1, T2, Aug, Bal> *L, *R;
+	int m1, m2;
+	if (node == NULL || lo >= hi)
+		return node;
+
+	m1 = m2 = bound(node->ID, ids, idx, lo, hi);
+	if (m2 < hi && cmp(ids[idx[m2]], node->ID) == 0)
+		++m2;
+	L = node->Son[0];
+	R = node->Son[1];
+	node->Son[0] = node->Son[1] = NULL;
+	if (L != NULL)
+		L->Par = NULL;
+	if (R != NULL)
+		R->Par = NULL;
+	L = differ(L, ids, idx, lo, m1);
+	R = differ(R, ids, idx, m2, hi);
+	if (m2 == m1)
+		return join(L, node, R);
+	if (finger == node)
+		finger = NULL;
+	if (node->dead)
+		--tombs;
+	else
+		--size;
+	delete node;
+	return join2(L, R);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insertBatch
+// DESCRIPTION: To insert a batch of IDs with one shared descent. The batch is
+//				sorted first; IDs already in the tree are skipped.
+//   ARGUMENTS: const T1 *ids - the IDs, in any order
+//				int n - the number of IDs
+// USES GLOBAL: none
+// MODIFIES GL: root, size
+//     RETURNS: int - the number of nodes inserted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::insertBatch(const T1 *ids, int n) {
+	return insertBatch(ids, NULL, n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: insertBatch
+// DESCRIPTION: To insert a batch of IDs and records with one shared descent.
+//				Of equal IDs in the batch, the first one is inserted.
+//   ARGUMENTS: const T1 *ids - the IDs, in any order
+//				const T2 *rcds - the records of the IDs, NULL for default
+//				int n - the number of IDs
+// USES GLOBAL: none
+// MODIFIES GL: root, size
+//     RETURNS: int - the number of nodes inserted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::insertBatch(const T1 *ids, const T2 *rcds, int n) {
+	vector<int> idx;
+	int before = size;
+	if (n <= 0)
+		return 0;
+	order(ids, n, idx);
+	root = unite(root, ids, rcds, &idx[0], 0, (int)idx.size());
+	root->Par = NULL;
+	return size - before;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: eraseBatch
+// DESCRIPTION: To delete a batch of IDs with one shared descent.
+//   ARGUMENTS: const T1 *ids - the IDs, in any order
+//				int n - the number of IDs
+// USES GLOBAL: none
+// MODIFIES GL: root, finger, size
+//     RETURNS: int - the number of nodes deleted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+int AVLTree<T1, T2, Aug, Bal, Cmp>::eraseBatch(const T1 *ids, int n) {
+	vector<int> idx;
+	int before = size;
+	if (n <= 0 || root == NULL)
+		return 0;
+	order(ids, n, idx);
+	root = differ(root, ids, &idx[0], 0, (int)idx.size());
+	if (root != NULL)
+		root->Par = NULL;
+	return before - size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: eraseRange
+// DESCRIPTION: To delete all the nodes with lo <= ID <= hi. The tree is split
+//				twice around the range, the middle is freed as a whole, and the
+//				two sides are joined back, costing O(log n + k) for k nodes.
+//				Tombstones in the range are freed as well.
+//   ARGUMENTS: const T1 &lo - the lower bound of the IDs
+//				const T1 &hi - the upper bound of the IDs
+// USES GLOBAL: none
+// MODIFIES GL: root, finger, size, tombs
+//     RETURNS: AVLSIZE - the number of live nodes deleted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLSIZE AVLTree<T1, T2, Aug, Bal, Cmp>::eraseRange(const T1 &lo, const T1 &hi) {
+	Node<T1, T2, Aug, Bal> *L, *M, *R;
+	AVLSIZE gone;
+	if (root == NULL || cmp(lo, hi) > 0)
+		return 0;
+	if (finger != NULL && cmp(finger->ID, lo) >= 0 && cmp(finger->ID, hi) <= 0)
+		finger = NULL;
+	split(root, lo, false, L, M);
+	split(M, hi, true, M, R);
+	gone = discard(M);
+	root = join2(L, R);
+	if (root != NULL)
+		root->Par = NULL;
+	return gone;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: stats
+// DESCRIPTION: To measure the shape and memory of the tree. The walk keeps a
+//				stack as deep as the tree instead of recursing, so it is
+//				O(n) time and O(log n) space and may run on a large live
+//				tree now and then. It reads but does not lock the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLSTATS
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLSTATS AVLTree<T1, T2, Aug, Bal, Cmp>::stats() const {
+	struct FRAME {
+		const Node<T1, T2, Aug, Bal> *node;
+		int hl;	// the height of the left subtree, once it is done
+		bool right;	// whether the right subtree is being walked
+	};
+	vector<FRAME> stack;
+	AVLSTATS st;
+	AVLSIZE depths = 0, links = 0, far = 0, near[5] = { 0 };	// the factors -2 to 2
+	const Node<T1, T2, Aug, Bal> *p = root;
+	int h = -1;	// the height of the last subtree done, -1 for none
+
+	// down the left spine measuring every node, then up through the nodes
+	// whose right subtrees are done, then into the next right subtree; the
+	// sons are prefetched, the right ones to be ready by the time they come
+	for (;;) {
+		for (; p != NULL; p = p->Son[0]) {
+			AVL_PF(p->Son[0]);
+			AVL_PF(p->Son[1]);
+			++st.nodes;
+			st.tombs += p->dead ? 1 : 0;
+			depths += (AVLSIZE)stack.size();
+			st.maxDepth = MAX(st.maxDepth, (int)stack.size());
+			st.nodeBytes += sizeof(*p);
+			st.slackBytes += AVLSTATS::slack(p, sizeof(*p));
+			if (!is_same<T2, NULLT>::value && p->getRcd() != NULL) {
+				st.rcdBytes += sizeof(T2);
+				st.slackBytes += AVLSTATS::slack(p->getRcd(), sizeof(T2));
+			}
+			if (!stack.empty()) {
+				++links;
+				far += ((uintptr_t)p >> 12) != ((uintptr_t)stack.back().node >> 12) ? 1 : 0;
+			}
+			stack.push_back({ p, -1, false });
+		}
+		h = -1;
+		while (!stack.empty() && stack.back().right) {
+			if (h - stack.back().hl >= -2 && h - stack.back().hl <= 2)
+				++near[h - stack.back().hl + 2];
+			else
+				++st.balance[h - stack.back().hl];
+			h = 1 + MAX(h, stack.back().hl);
+			stack.pop_back();
+		}
+		if (stack.empty())
+			break;
+		stack.back().hl = h;
+		stack.back().right = true;
+		p = stack.back().node->Son[1];
+	}
+	for (int i = 0; i < 5; i++)
+		if (near[i] > 0)
+			st.balance[i - 2] += near[i];
+	st.height = h;
+	st.avgDepth = st.nodes > 0 ? double(depths) / st.nodes : 0;
+	st.farLinks = links > 0 ? double(far) / links : 0;
+	return st;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: toDot
+// DESCRIPTION: To write the top of the tree as a Graphviz digraph. A node is
+//				labelled with the field its balance policy keeps (the
+//				height, rank or weight), tombstones are dashed, and subtrees
+//				below "depth" are cut to one "..." node. Nodes need no
+//				operator<< on T1. The walk keeps a stack as stats does.
+//   ARGUMENTS: ostream &out = cout - the stream
+//				int depth = 6 - the deepest level written, the root at 0
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::toDot(ostream &out, int depth) const {
+	struct DOTNODE {
+		const Node<T1, T2, Aug, Bal> *node;
+		AVLSIZE id;	// its number in the graph
+		int depth;
+	};
+	vector<DOTNODE> stack;
+	const Node<T1, T2, Aug, Bal> *sons[2];
+	AVLSIZE next = 0;
+
+	out << "digraph AVLTree {" << endl << "\tnode [shape=circle];" << endl;
+	if (root != NULL)
+		stack.push_back({ root, next++, 0 });
+	while (!stack.empty()) {
+		DOTNODE d = stack.back();
+		stack.pop_back();
+		out << "\tn" << d.id << " [label=\"" << d.node->height << '"' << (d.node->dead ? ", style=dashed" : "") << "];" << endl;
+		sons[0] = d.node->Son[0];
+		sons[1] = d.node->Son[1];
+		for (int i = 0; i < 2; i++) {
+			if (sons[i] == NULL)
+				continue;
+			out << "\tn" << d.id << " -> n" << next << (i ? " [label=R]" : " [label=L]") << ';' << endl;
+			if (d.depth < depth)
+				stack.push_back({ sons[i], next++, d.depth + 1 });
+			else
+				out << "\tn" << next++ << " [label=\"...\", shape=plaintext];" << endl;
+		}
+	}
+	out << '}' << endl;
+	return out.good();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1076,10 +2838,10 @@ bool AVLTree<T1, T2>::Delete(const T1 &id) {
 //     RETURNS: bool
 //      AUTHOR: Kingston Chan
 // AUTHOR/DATE: KC 2015-02-11
-//							KC 2015-02-11
+//							agent 2026-10-19
 ////////////////////////////////////////////////////////////////////////////////
-template<class T1, class T2>
-bool AVLTree<T1, T2>::print() const {
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLTree<T1, T2, Aug, Bal, Cmp>::print() const {
 	if (root != NULL) {
 		root->print();
 		return true;
@@ -1088,4 +2850,152 @@ bool AVLTree<T1, T2>::print() const {
 		return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: AVLCURSOR
+// DESCRIPTION: Constructor of AVLCURSOR class, over the whole tree.
+//   ARGUMENTS: AVLTree<T1, T2, Aug, Bal, Cmp> &tree - the tree to walk
+// USES GLOBAL: none
+// MODIFIES GL: tree, begun, bounded, over
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLCURSOR<T1, T2, Aug, Bal, Cmp>::AVLCURSOR(AVLTree<T1, T2, Aug, Bal, Cmp> &tree) {
+	this->tree = &tree;
+	begun = bounded = over = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: AVLCURSOR
+// DESCRIPTION: Constructor of AVLCURSOR class, over lo <= ID <= hi.
+//   ARGUMENTS: AVLTree<T1, T2, Aug, Bal, Cmp> &tree - the tree to walk
+//				const T1 &lo - the lower bound of the IDs
+//				const T1 &hi - the upper bound of the IDs
+// USES GLOBAL: none
+// MODIFIES GL: tree, at, hi, begun, bounded, over
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLCURSOR<T1, T2, Aug, Bal, Cmp>::AVLCURSOR(AVLTree<T1, T2, Aug, Bal, Cmp> &tree, const T1 &lo, const T1 &hi) {
+	this->tree = &tree;
+	at = lo;
+	this->hi = hi;
+	begun = bounded = true;
+	over = tree.getCmp()(lo, hi) > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: start
+// DESCRIPTION: To find the first live node that is still to be visited.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: const Node<T1, T2, Aug, Bal>* - NULL if there is none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+const Node<T1, T2, Aug, Bal> *AVLCURSOR<T1, T2, Aug, Bal, Cmp>::start() const {
+	const Node<T1, T2, Aug, Bal> *p;
+	if (begun)
+		return tree->lowerNode(at);
+	p = tree->getRoot();
+	if (p == NULL)
+		return NULL;
+	while (p->getLft() != NULL)
+		p = p->getLft();
+	return p->isDead() ? p->next() : p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: inside
+// DESCRIPTION: To check that a node is not past the end of the walk.
+//   ARGUMENTS: const Node<T1, T2, Aug, Bal> *node - the node, may be NULL
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+bool AVLCURSOR<T1, T2, Aug, Bal, Cmp>::inside(const Node<T1, T2, Aug, Bal> *node) const {
+	return node != NULL && (!bounded || tree->getCmp()(node->getID(), hi) <= 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: scan
+// DESCRIPTION: To visit the next "steps" nodes in order, resuming where the
+//				last step stopped. It costs O(log n + steps).
+//   ARGUMENTS: F visit - called with a const Node<T1, T2, Aug, Bal>* per node
+//				AVLSIZE steps - the most nodes to visit
+// USES GLOBAL: none
+// MODIFIES GL: at, begun, over
+//     RETURNS: AVLSIZE - the number of nodes visited
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+template<class F>
+AVLSIZE AVLCURSOR<T1, T2, Aug, Bal, Cmp>::scan(F visit, AVLSIZE steps) {
+	const Node<T1, T2, Aug, Bal> *p;
+	AVLSIZE n = 0;
+	if (over)
+		return 0;
+	for (p = start(); n < steps && inside(p); p = p->next(), n++)
+		visit(p);
+	if (inside(p)) {
+		at = p->getID();
+		begun = true;
+	}
+	else
+		over = true;
+	return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: erase
+// DESCRIPTION: To delete the next "steps" nodes in order with one eraseRange,
+//				resuming where the last step stopped. It costs
+//				O(log n + steps), so every step has a bounded latency.
+//   ARGUMENTS: AVLSIZE steps - the most nodes to delete
+// USES GLOBAL: none
+// MODIFIES GL: tree, at, begun, over
+//     RETURNS: AVLSIZE - the number of nodes deleted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal, class Cmp>
+AVLSIZE AVLCURSOR<T1, T2, Aug, Bal, Cmp>::erase(AVLSIZE steps) {
+	const Node<T1, T2, Aug, Bal> *first, *last, *p;
+	AVLSIZE n = 1;
+	T1 lo, upto;	// copies, as eraseRange frees the nodes they come from
+	if (over || steps <= 0)
+		return 0;
+	first = start();
+	if (!inside(first)) {
+		over = true;
+		return 0;
+	}
+	for (last = first, p = first->next(); n < steps && inside(p); last = p, p = p->next())
+		n++;
+	lo = first->getID();
+	upto = last->getID();
+	if (inside(p)) {
+		at = p->getID();
+		begun = true;
+	}
+	else
+		over = true;
+	return tree->eraseRange(lo, upto);
+}
+
 #endif
@@ -0,0 +1,260 @@
+/*
+BucketAVLTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef BUCKETAVLTREE_H
+#define BUCKETAVLTREE_H
+
+#include "AVLTree.h"
+
+// Up to B keys kept sorted in an array, with their records alongside.
+template<class T1, class T2, int B>
+class BUCKET {
+public :
+	int cnt;
+	T1 key[B];
+	T2 rcd[B];
+	BUCKET() { cnt = 0; }
+	// the number of keys less than id; branch free so that it vectorizes
+	int rank(const T1 &id) const {
+		int pos = 0;
+		for (int i = 0; i < cnt; i++)
+			pos += key[i] < id;
+		return pos;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////Bucket AVL tree/////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// An AVL tree of buckets. Every node is keyed by a fence no larger than the
+// keys of its bucket, and all of them are less than the next node's fence, so
+// a key lives in the bucket of the last fence not after it. Balancing and
+// rotations only see the buckets, which cuts the height by about log2(B).
+// Keys are ordered by operator<.
+template<class T1, class T2 = NULLT, int B = 32>
+class BucketAVLTree : protected AVLTree<T1, BUCKET<T1, T2, B> > {
+
+private :
+	AVLSIZE keys;
+
+	Node<T1, BUCKET<T1, T2, B> > *bucketOf(const T1 &id) const;
+	bool put(const T1 &id, const T2 &rcd);
+public :
+	BucketAVLTree() { keys = 0; }
+
+	bool Insert(const T1 &id) { return put(id, T2()); }
+	bool Insert(const T1 &id, const T2 &rcd) { return put(id, rcd); }
+	bool Delete(const T1 &id);
+	bool empty();
+
+	AVLSIZE getSize() const { return keys; }
+	AVLSIZE getBuckets() const { return this->size; }
+	int getHeight() const { return AVLTree<T1, BUCKET<T1, T2, B> >::getHeight(); }
+	T2 *find(const T1 &id) const;
+	bool contains(const T1 &id) const { return find(id) != NULL; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: bucketOf
+// DESCRIPTION: To find the node whose bucket covers the key "id", i.e. the
+//				one with the last fence not after id.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: Node<T1, BUCKET<T1, T2, B> >* - NULL if id is before all fences
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, int B>
+Node<T1, BUCKET<T1, T2, B> > *BucketAVLTree<T1, T2, B>::bucketOf(const T1 &id) const {
+	Node<T1, BUCKET<T1, T2, B> > *p = this->root, *hit = NULL;
+	while (p != NULL) {
+		if (id < p->getID())
+			p = p->getLft();
+		else {
+			hit = p;
+			p = p->getRgt();
+		}
+	}
+	return hit;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: put
+// DESCRIPTION: To insert a key with its record into its bucket. A full bucket
+//				is split in halves first, the upper half going to a new node.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, keys
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, int B>
+bool BucketAVLTree<T1, T2, B>::put(const T1 &id, const T2 &rcd) {
+	Node<T1, BUCKET<T1, T2, B> > *node = bucketOf(id), *half;
+	BUCKET<T1, T2, B> *bkt, *up;
+	bool fresh;
+	int pos, i;
+
+	if (node == NULL) {
+		if (this->root == NULL)
+			node = this->attach(this->root, id, NULL, fresh);
+		else {
+			// id is before all fences: lower the first one
+			for (node = this->root; node->getLft() != NULL; node = node->getLft());
+			node->ModifyID(id);
+		}
+	}
+	bkt = node->getRcd();
+	pos = bkt->rank(id);
+	if (pos < bkt->cnt && !(id < bkt->key[pos]))
+		return false;
+
+	if (bkt->cnt == B) {
+		half = this->attach(this->root, bkt->key[B / 2], NULL, fresh);
+		up = half->getRcd();
+		for (i = B / 2; i < B; i++) {
+			up->key[i - B / 2] = bkt->key[i];
+			up->rcd[i - B / 2] = bkt->rcd[i];
+		}
+		up->cnt = B - B / 2;
+		bkt->cnt = B / 2;
+		if (pos > B / 2) {
+			bkt = up;
+			pos -= B / 2;
+		}
+	}
+	for (i = bkt->cnt; i > pos; i--) {
+		bkt->key[i] = bkt->key[i - 1];
+		bkt->rcd[i] = bkt->rcd[i - 1];
+	}
+	bkt->key[pos] = id;
+	bkt->rcd[pos] = rcd;
+	++bkt->cnt;
+	++keys;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete a key from its bucket. A bucket under a quarter full
+//				takes in the next one if they fit together, and an empty
+//				bucket is removed with its node.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, keys
+//     RETURNS: bool - false if the key is not in the tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, int B>
+bool BucketAVLTree<T1, T2, B>::Delete(const T1 &id) {
+	Node<T1, BUCKET<T1, T2, B> > *node = bucketOf(id), *nxt;
+	BUCKET<T1, T2, B> *bkt, *bn;
+	int pos, i;
+
+	if (node == NULL)
+		return false;
+	bkt = node->getRcd();
+	pos = bkt->rank(id);
+	if (pos == bkt->cnt || id < bkt->key[pos])
+		return false;
+	for (i = pos + 1; i < bkt->cnt; i++) {
+		bkt->key[i - 1] = bkt->key[i];
+		bkt->rcd[i - 1] = bkt->rcd[i];
+	}
+	--bkt->cnt;
+	--keys;
+
+	if (bkt->cnt == 0) {
+		this->unlink(node);
+		delete node;
+	}
+	else if (bkt->cnt < B / 4 && (nxt = node->next()) != NULL
+		&& bkt->cnt + (bn = nxt->getRcd())->cnt <= B) {
+		for (i = 0; i < bn->cnt; i++) {
+			bkt->key[bkt->cnt + i] = bn->key[i];
+			bkt->rcd[bkt->cnt + i] = bn->rcd[i];
+		}
+		bkt->cnt += bn->cnt;
+		this->unlink(nxt);
+		delete nxt;
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: empty
+// DESCRIPTION: To delete all the keys in the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, finger, size, keys
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, int B>
+bool BucketAVLTree<T1, T2, B>::empty() {
+	keys = 0;
+	return AVLTree<T1, BUCKET<T1, T2, B> >::empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find the record of a key: one descent over the fences, then
+//				a scan of a single bucket.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2* - NULL if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, int B>
+T2 *BucketAVLTree<T1, T2, B>::find(const T1 &id) const {
+	Node<T1, BUCKET<T1, T2, B> > *node = bucketOf(id);
+	BUCKET<T1, T2, B> *bkt;
+	int pos;
+	if (node == NULL)
+		return NULL;
+	bkt = node->getRcd();
+	pos = bkt->rank(id);
+	if (pos == bkt->cnt || id < bkt->key[pos])
+		return NULL;
+	return &bkt->rcd[pos];
+}
+
+#endif
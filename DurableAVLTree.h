@@ -0,0 +1,691 @@
+/*
+DurableAVLTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef DURABLEAVLTREE_H
+#define DURABLEAVLTREE_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include "AVLTree.h"
+
+#ifdef _WIN32
+#include <io.h>
+#define AVL_FSYNC(f) _commit(_fileno(f))
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#define AVL_FSYNC(f) fsync(fileno(f))
+#endif
+
+// How a key or a record is written to the log: put appends its bytes to a
+// buffer, get reads them back and moves "p" past them, failing on a short
+// buffer. The default copies the bytes of trivially copyable types.
+template<class T>
+class RAWIO {
+public :
+	static void put(std::vector<char> &buf, const T &v) {
+		static_assert(std::is_trivially_copyable<T>::value, "give DurableAVLTree an IO class for this type");
+		buf.insert(buf.end(), (const char *)&v, (const char *)&v + sizeof(T));
+	}
+	static bool get(const char *&p, const char *end, T &v) {
+		if (end - p < (long)sizeof(T))
+			return false;
+		memcpy((void *)&v, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+};
+
+template<>
+class RAWIO<NULLT> {
+public :
+	static void put(std::vector<char> &buf, const NULLT &v) {}
+	static bool get(const char *&p, const char *end, NULLT &v) { return true; }
+};
+
+template<>
+class RAWIO<std::string> {
+public :
+	static void put(std::vector<char> &buf, const std::string &v) {
+		unsigned int len = (unsigned int)v.size();
+		RAWIO<unsigned int>::put(buf, len);
+		buf.insert(buf.end(), v.begin(), v.end());
+	}
+	static bool get(const char *&p, const char *end, std::string &v) {
+		unsigned int len;
+		if (!RAWIO<unsigned int>::get(p, end, len) || (unsigned long)(end - p) < len)
+			return false;
+		v.assign(p, len);
+		p += len;
+		return true;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////Durable AVL tree//////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// An AVL tree kept on disk as a checkpoint, a sorted snapshot, plus a write
+// ahead log of the changes since. Changes are framed with their length and
+// a checksum and buffered; the buffer goes to the log with one write and one
+// fsync once "every" changes are buffered or the oldest of them has waited
+// "millis" milliseconds, whichever comes first, so a change is durable after
+// the next sync rather than at once. A background thread keeps the time
+// bound while no changes come; a lock, held by the changes, sync and
+// checkpoint, keeps it off the tree and the buffer while they run.
+// Once the log passes "limit" bytes a new checkpoint replaces the old one by
+// rename and the log starts over.
+//
+// Opening the tree reads the checkpoint, links its nodes into a balanced tree
+// in linear time, and replays the log up to the first torn or corrupt frame.
+// Every logged change sets or removes one key, so replaying a log that the
+// checkpoint already holds, after a crash between the two, does no harm.
+template<class T1, class T2 = NULLT, class IO1 = RAWIO<T1>, class IO2 = RAWIO<T2> >
+class DurableAVLTree : protected AVLTree<T1, T2> {
+
+private :
+	std::string path;	// the log is path + ".wal", the checkpoint path + ".ckpt"
+	FILE *wal;
+	std::vector<char> pending;	// framed changes not written yet
+	int unsynced;
+	int every;
+	int millis;
+	long long limit;
+	long long logged;	// bytes in the log
+	std::chrono::steady_clock::time_point oldest;	// when pending was started
+	std::mutex lock;
+	std::condition_variable wake;	// pending was started, or closing
+	std::thread flusher;
+	bool closing;
+	bool broken;	// the flusher could not write the log
+
+	static unsigned int checksum(const char *p, size_t n);
+	void frame(std::vector<char> &buf, char op, const T1 &id, const T2 *rcd) const;
+	bool unframe(const char *&p, const char *end, char &op, T1 &id, T2 &rcd) const;
+	void log(char op, const T1 &id, const T2 *rcd);
+	bool commit();
+	bool rewrite();
+	void flush();
+	void load();
+	void replay();
+	DurableAVLTree(const DurableAVLTree &);
+public :
+	DurableAVLTree(const std::string &file, int every = 256, int millis = 10, long long limit = 64LL << 20);
+	~DurableAVLTree();
+
+	bool Insert(const T1 &id);
+	bool Insert(const T1 &id, const T2 &rcd);
+	bool Modify(const T1 &id, const T2 &rcd);
+	bool Delete(const T1 &id);
+	bool sync();
+	bool checkpoint();
+
+	using AVLTree<T1, T2>::find;
+	using AVLTree<T1, T2>::contains;
+	using AVLTree<T1, T2>::getSize;
+	long long getLogBytes() const { return logged + (long long)pending.size(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: checksum
+// DESCRIPTION: To hash a frame's bytes, FNV-1a, so that a torn or corrupt
+//				frame at the end of the log is told from a whole one.
+//   ARGUMENTS: const char *p - the bytes
+//				size_t n - how many
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: unsigned int
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+unsigned int DurableAVLTree<T1, T2, IO1, IO2>::checksum(const char *p, size_t n) {
+	unsigned int h = 2166136261u;
+	for (size_t i = 0; i < n; i++) {
+		h ^= (unsigned char)p[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: frame
+// DESCRIPTION: To append a change to a buffer as a frame: the length and the
+//				checksum of the body, then the body of the operation ('I' to
+//				set a key, 'D' to remove it), the key and the record.
+//   ARGUMENTS: std::vector<char> &buf - the buffer
+//				char op - the operation
+//				const T1 &id - the key
+//				const T2 *rcd - the record, NULL for 'D'
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+void DurableAVLTree<T1, T2, IO1, IO2>::frame(std::vector<char> &buf, char op, const T1 &id, const T2 *rcd) const {
+	size_t head = buf.size();
+	unsigned int len, sum;
+
+	buf.resize(head + 2 * sizeof(unsigned int));
+	buf.push_back(op);
+	IO1::put(buf, id);
+	if (rcd != NULL)
+		IO2::put(buf, *rcd);
+	len = (unsigned int)(buf.size() - head - 2 * sizeof(unsigned int));
+	sum = checksum(&buf[head + 2 * sizeof(unsigned int)], len);
+	memcpy(&buf[head], &len, sizeof(len));
+	memcpy(&buf[head + sizeof(len)], &sum, sizeof(sum));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: unframe
+// DESCRIPTION: To read a frame back and move "p" past it.
+//   ARGUMENTS: const char *&p - the frame
+//				const char *end - the end of the bytes read
+//				char &op, T1 &id, T2 &rcd - receive the change
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - false if the frame is short, corrupt or unknown
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::unframe(const char *&p, const char *end, char &op, T1 &id, T2 &rcd) const {
+	unsigned int len, sum;
+	const char *body;
+
+	if (!RAWIO<unsigned int>::get(p, end, len) || !RAWIO<unsigned int>::get(p, end, sum)
+		|| (unsigned long)(end - p) < len || len == 0 || checksum(p, len) != sum)
+		return false;
+	body = p;
+	end = p + len;
+	op = *body++;
+	if (!IO1::get(body, end, id))
+		return false;
+	if (op == 'I') {
+		if (!IO2::get(body, end, rcd))
+			return false;
+	}
+	else if (op != 'D')
+		return false;
+	if (body != end)
+		return false;
+	p = end;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: DurableAVLTree
+// DESCRIPTION: Constructor of DurableAVLTree class. It recovers the tree from
+//				the checkpoint and the log under "file", if there are any.
+//   ARGUMENTS: const std::string &file - the path the two files are named after
+//				int every = 256 - the changes that force a sync
+//				int millis = 10 - the milliseconds after which a change
+//				is synced by the background thread, 0 for no time bound
+//				and no thread
+//				long long limit = 64M - the log bytes that force a
+//				checkpoint, 0 for checkpoints only by hand
+// USES GLOBAL: none
+// MODIFIES GL: root, size, path, wal, every, millis, limit, logged,
+//				closing, broken, flusher
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+DurableAVLTree<T1, T2, IO1, IO2>::DurableAVLTree(const std::string &file, int every, int millis, long long limit) {
+	path = file;
+	wal = NULL;
+	unsynced = 0;
+	this->every = every > 0 ? every : 1;
+	this->millis = millis;
+	this->limit = limit;
+	logged = 0;
+	closing = broken = false;
+	load();
+	replay();
+	if (this->millis > 0)
+		flusher = std::thread(&DurableAVLTree<T1, T2, IO1, IO2>::flush, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ~DurableAVLTree
+// DESCRIPTION: Destructor of DurableAVLTree class. It stops the background
+//				thread and syncs the changes left.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: wal, closing
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+DurableAVLTree<T1, T2, IO1, IO2>::~DurableAVLTree() {
+	{
+		std::lock_guard<std::mutex> hold(lock);
+		closing = true;
+	}
+	wake.notify_one();
+	if (flusher.joinable())
+		flusher.join();
+	try {
+		commit();
+	}
+	catch (AVLERR &) {
+	}
+	if (wal != NULL)
+		fclose(wal);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: load
+// DESCRIPTION: To read the checkpoint, whose frames are in increasing order,
+//				and link its nodes into a balanced tree in linear time.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, size
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+void DurableAVLTree<T1, T2, IO1, IO2>::load() {
+	FILE *f = fopen((path + ".ckpt").c_str(), "rb");
+	std::vector<char> bytes;
+	std::vector<Node<T1, T2> *> nodes;
+	const char *p, *end;
+	long long count = 0;
+	char op;
+	T1 id;
+	T2 rcd;
+
+	if (f == NULL)
+		return;
+	fseek(f, 0, SEEK_END);
+	bytes.resize(ftell(f));
+	fseek(f, 0, SEEK_SET);
+	if (!bytes.empty() && fread(&bytes[0], 1, bytes.size(), f) != bytes.size())
+		bytes.clear();
+	fclose(f);
+
+	p = bytes.empty() ? NULL : &bytes[0];
+	end = p + bytes.size();
+	if (!RAWIO<long long>::get(p, end, count))
+		throw AVLERR("corrupt checkpoint");
+	nodes.reserve(count);
+	while ((long long)nodes.size() < count) {
+		if (!unframe(p, end, op, id, rcd) || op != 'I'
+			|| (!nodes.empty() && this->cmp(nodes.back()->getID(), id) >= 0)) {
+			for (size_t i = 0; i < nodes.size(); i++)
+				delete nodes[i];
+			throw AVLERR("corrupt checkpoint");
+		}
+		nodes.push_back(new Node<T1, T2>(id, &rcd));
+	}
+	if (!nodes.empty())
+		this->root = this->relink(&nodes[0], 0, (AVLSIZE)nodes.size());
+	this->size = (AVLSIZE)nodes.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: replay
+// DESCRIPTION: To apply the log onto the checkpoint up to its first bad
+//				frame, and then, if it held anything, fold it into a new
+//				checkpoint so that the log starts empty.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, size, wal, logged
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+void DurableAVLTree<T1, T2, IO1, IO2>::replay() {
+	FILE *f = fopen((path + ".wal").c_str(), "rb");
+	std::vector<char> bytes;
+	const char *p, *end;
+	char op;
+	T1 id;
+	T2 rcd;
+
+	if (f != NULL) {
+		fseek(f, 0, SEEK_END);
+		bytes.resize(ftell(f));
+		fseek(f, 0, SEEK_SET);
+		if (!bytes.empty() && fread(&bytes[0], 1, bytes.size(), f) != bytes.size())
+			bytes.clear();
+		fclose(f);
+	}
+	if (bytes.empty()) {
+		wal = fopen((path + ".wal").c_str(), "ab");
+		if (wal == NULL)
+			throw AVLERR("cannot open the log");
+		return;
+	}
+
+	p = &bytes[0];
+	end = p + bytes.size();
+	while (unframe(p, end, op, id, rcd)) {
+		if (op == 'D')
+			AVLTree<T1, T2>::Delete(id);
+		else if (!AVLTree<T1, T2>::Insert(id, rcd))
+			AVLTree<T1, T2>::Modify(id, rcd);
+	}
+	checkpoint();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: log
+// DESCRIPTION: To buffer a change, and sync if enough changes are buffered
+//				or the oldest has waited long enough. The first change of a
+//				buffer wakes the background thread to time it. The caller
+//				holds the lock.
+//   ARGUMENTS: char op - the operation
+//				const T1 &id - the key
+//				const T2 *rcd - the record, NULL for 'D'
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, oldest
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+void DurableAVLTree<T1, T2, IO1, IO2>::log(char op, const T1 &id, const T2 *rcd) {
+	if (broken)
+		throw AVLERR("cannot write the log");
+	if (pending.empty()) {
+		oldest = std::chrono::steady_clock::now();
+		wake.notify_one();
+	}
+	frame(pending, op, id, rcd);
+	if (++unsynced >= every || (millis > 0
+		&& std::chrono::steady_clock::now() - oldest >= std::chrono::milliseconds(millis)))
+		commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: flush
+// DESCRIPTION: The background thread: it sleeps while nothing is buffered,
+//				and syncs once the oldest buffered change has waited "millis"
+//				milliseconds. A failed write marks the tree broken, so that
+//				the next change or sync throws instead.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, logged, broken
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+void DurableAVLTree<T1, T2, IO1, IO2>::flush() {
+	std::unique_lock<std::mutex> hold(lock);
+	std::chrono::steady_clock::time_point due;
+	while (!closing) {
+		if (pending.empty() || broken) {
+			wake.wait(hold);
+			continue;
+		}
+		due = oldest + std::chrono::milliseconds(millis);
+		if (std::chrono::steady_clock::now() < due) {
+			wake.wait_until(hold, due);
+			continue;
+		}
+		try {
+			commit();
+		}
+		catch (AVLERR &) {
+			broken = true;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: sync
+// DESCRIPTION: To write the buffered changes to the log with one write and
+//				one fsync, making them durable, and to checkpoint if the log
+//				has grown past its limit.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, logged
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::sync() {
+	std::lock_guard<std::mutex> hold(lock);
+	if (broken)
+		throw AVLERR("cannot write the log");
+	return commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: commit
+// DESCRIPTION: To write the buffered changes to the log with one write and
+//				one fsync, and to checkpoint if the log has grown past its
+//				limit. The caller holds the lock.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, logged
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::commit() {
+	unsynced = 0;
+	if (pending.empty())
+		return true;
+	if (fwrite(&pending[0], 1, pending.size(), wal) != pending.size()
+		|| fflush(wal) != 0 || AVL_FSYNC(wal) != 0)
+		throw AVLERR("cannot write the log");
+	logged += (long long)pending.size();
+	pending.clear();
+	if (limit > 0 && logged >= limit)
+		rewrite();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: checkpoint
+// DESCRIPTION: To write the whole tree in order to a new checkpoint, sync
+//				it, put it in place of the old one by rename, and empty the
+//				log, whose changes the checkpoint now holds.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, wal, logged
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::checkpoint() {
+	std::lock_guard<std::mutex> hold(lock);
+	return rewrite();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: rewrite
+// DESCRIPTION: To write the checkpoint and empty the log, as checkpoint does.
+//				The caller holds the lock.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: pending, unsynced, wal, logged
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::rewrite() {
+	std::string tmp = path + ".ckpt.tmp", ckpt = path + ".ckpt";
+	std::vector<char> buf;
+	const Node<T1, T2> *p;
+	long long count = this->size;
+	FILE *f;
+
+	RAWIO<long long>::put(buf, count);
+	for (p = this->root; p != NULL && p->getLft() != NULL; p = p->getLft())
+		;
+	for (; p != NULL; p = p->next())
+		frame(buf, 'I', p->getID(), p->getRcd());
+	f = fopen(tmp.c_str(), "wb");
+	if (f == NULL)
+		throw AVLERR("cannot write the checkpoint");
+	if (fwrite(&buf[0], 1, buf.size(), f) != buf.size() || fflush(f) != 0 || AVL_FSYNC(f) != 0) {
+		fclose(f);
+		throw AVLERR("cannot write the checkpoint");
+	}
+	fclose(f);
+#ifdef _WIN32
+	remove(ckpt.c_str());
+#endif
+	if (rename(tmp.c_str(), ckpt.c_str()) != 0)
+		throw AVLERR("cannot write the checkpoint");
+#ifndef _WIN32
+	// make the rename itself durable
+	std::string dir = path.find('/') == std::string::npos ? "." : path.substr(0, path.rfind('/') + 1);
+	int fd = open(dir.c_str(), O_RDONLY);
+	if (fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+#endif
+
+	if (wal != NULL)
+		fclose(wal);
+	wal = fopen((path + ".wal").c_str(), "wb");
+	if (wal == NULL)
+		throw AVLERR("cannot open the log");
+	pending.clear();
+	unsynced = 0;
+	logged = 0;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a key and log it.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size, pending
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::Insert(const T1 &id) {
+	T2 rcd = T2();
+	return Insert(id, rcd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a key with its record and log it.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size, pending
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::Insert(const T1 &id, const T2 &rcd) {
+	std::lock_guard<std::mutex> hold(lock);
+	if (!AVLTree<T1, T2>::Insert(id, rcd))
+		return false;
+	log('I', id, &rcd);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Modify
+// DESCRIPTION: To replace the record of a key and log it.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the new record
+// USES GLOBAL: none
+// MODIFIES GL: pending
+//     RETURNS: bool - false if the key is not in the tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::Modify(const T1 &id, const T2 &rcd) {
+	std::lock_guard<std::mutex> hold(lock);
+	if (!AVLTree<T1, T2>::Modify(id, rcd))
+		return false;
+	log('I', id, &rcd);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete a key and log it.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size, pending
+//     RETURNS: bool - false if the key is not in the tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class IO1, class IO2>
+bool DurableAVLTree<T1, T2, IO1, IO2>::Delete(const T1 &id) {
+	std::lock_guard<std::mutex> hold(lock);
+	if (!AVLTree<T1, T2>::Delete(id))
+		return false;
+	log('D', id, NULL);
+	return true;
+}
+
+#endif
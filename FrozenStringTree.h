@@ -0,0 +1,374 @@
+/*
+FrozenStringTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef FROZENSTRINGTREE_H
+#define FROZENSTRINGTREE_H
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include "AVLTree.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////Frozen string tree/////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A read-only map of string keys, built once from sorted keys and stored
+// front coded. The keys are cut into blocks of "block" keys in one byte
+// array. The first key of a block is stored whole; every other key stores
+// only the length of the prefix it shares with the key before it and the
+// rest of its bytes. A lookup binary searches the first keys of the blocks,
+// then scans one block. The scan tracks how much of the query the previous
+// key matched, so most keys are passed or rejected by their shared prefix
+// length alone, without decoding them or comparing any bytes. Keys are
+// ordered by their bytes, unsigned, as std::string compares them.
+template<class T2 = NULLT>
+class FrozenStringTree {
+
+private :
+	vector<char> bytes;	// the blocks of front coded keys
+	vector<size_t> blocks;	// the offset of every block in bytes
+	vector<T2> rcds;	// the records in key order
+	int block;
+	AVLSIZE size;
+
+	static void put(vector<char> &out, size_t v);
+	static size_t get(const char *&p);
+	void build(const vector<const string *> &ids);
+	template<class Aug, class Bal>
+	void gather(const Node<string, T2, Aug, Bal> *node, vector<const string *> &ids);
+public :
+	FrozenStringTree(const string *ids, const T2 *rcds, AVLSIZE n, int block = 16);
+	FrozenStringTree(const string *ids, AVLSIZE n, int block = 16);
+	template<class Aug, class Bal>
+	FrozenStringTree(const AVLTree<string, T2, Aug, Bal> &tree, int block = 16);
+
+	const T2 *find(const string &id) const;
+	bool contains(const string &id) const { return find(id) != NULL; }
+	string getKey(AVLSIZE i) const;
+	AVLSIZE getSize() const { return size; }
+	size_t getBytes() const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: put
+// DESCRIPTION: To append a number in 7 bit groups, the low ones first, with
+//				the top bit of every byte but the last set.
+//   ARGUMENTS: vector<char> &out - the bytes to append to
+//				size_t v - the number
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+void FrozenStringTree<T2>::put(vector<char> &out, size_t v) {
+	while (v >= 0x80) {
+		out.push_back((char)(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back((char)v);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: get
+// DESCRIPTION: To read a number written by put and step past it.
+//   ARGUMENTS: const char *&p - the bytes, moved past the number
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: size_t
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+size_t FrozenStringTree<T2>::get(const char *&p) {
+	size_t v = 0;
+	int shift = 0;
+	while ((unsigned char)*p >= 0x80) {
+		v |= (size_t)((unsigned char)*p++ & 0x7f) << shift;
+		shift += 7;
+	}
+	return v | (size_t)(unsigned char)*p++ << shift;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: build
+// DESCRIPTION: To front code sorted, distinct keys into blocks.
+//   ARGUMENTS: const vector<const string *> &ids - the keys in order
+// USES GLOBAL: none
+// MODIFIES GL: bytes, blocks, size
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+void FrozenStringTree<T2>::build(const vector<const string *> &ids) {
+	size_t lcp;
+	size = (AVLSIZE)ids.size();
+	for (AVLSIZE i = 0; i < size; i++) {
+		const string &id = *ids[i];
+		if (i % block == 0) {
+			blocks.push_back(bytes.size());
+			put(bytes, id.size());
+			bytes.insert(bytes.end(), id.begin(), id.end());
+			continue;
+		}
+		const string &prev = *ids[i - 1];
+		for (lcp = 0; lcp < id.size() && lcp < prev.size() && id[lcp] == prev[lcp]; lcp++);
+		put(bytes, lcp);
+		put(bytes, id.size() - lcp);
+		bytes.insert(bytes.end(), id.begin() + lcp, id.end());
+	}
+	bytes.shrink_to_fit();
+	blocks.shrink_to_fit();
+	rcds.shrink_to_fit();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: FrozenStringTree
+// DESCRIPTION: Constructor of FrozenStringTree class. The keys need not be
+//				sorted; of equal keys, the first one is kept.
+//   ARGUMENTS: const string *ids - the keys
+//				const T2 *rcds - the records of the keys, NULL for none
+//				AVLSIZE n - the number of keys
+//				int block = 16 - the keys in a block
+// USES GLOBAL: none
+// MODIFIES GL: bytes, blocks, rcds, block, size
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+FrozenStringTree<T2>::FrozenStringTree(const string *ids, const T2 *rcds, AVLSIZE n, int block) {
+	vector<AVLSIZE> idx;
+	vector<const string *> keys;
+
+	this->block = block > 0 ? block : 16;
+	for (AVLSIZE i = 0; i < n; i++)
+		idx.push_back(i);
+	std::stable_sort(idx.begin(), idx.end(), [ids](AVLSIZE a, AVLSIZE b) { return ids[a] < ids[b]; });
+	for (AVLSIZE i = 0; i < n; i++) {
+		if (i > 0 && ids[idx[i]] == ids[idx[i - 1]])
+			continue;
+		keys.push_back(&ids[idx[i]]);
+		this->rcds.push_back(rcds == NULL ? T2() : rcds[idx[i]]);
+	}
+	build(keys);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: FrozenStringTree
+// DESCRIPTION: Constructor of FrozenStringTree class, for a set.
+//   ARGUMENTS: const string *ids - the keys
+//				AVLSIZE n - the number of keys
+//				int block = 16 - the keys in a block
+// USES GLOBAL: none
+// MODIFIES GL: bytes, blocks, rcds, block, size
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+FrozenStringTree<T2>::FrozenStringTree(const string *ids, AVLSIZE n, int block) :
+	FrozenStringTree(ids, NULL, n, block) {}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: gather
+// DESCRIPTION: To collect the live keys and records of a subtree in order.
+//   ARGUMENTS: const Node<string, T2, Aug, Bal> *node - the subtree
+//				vector<const string *> &ids - receives the keys
+// USES GLOBAL: none
+// MODIFIES GL: rcds
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+template<class Aug, class Bal>
+void FrozenStringTree<T2>::gather(const Node<string, T2, Aug, Bal> *node, vector<const string *> &ids) {
+	if (node == NULL)
+		return;
+	gather(node->getLft(), ids);
+	if (!node->isDead()) {
+		ids.push_back(&node->getID());
+		rcds.push_back(node->getRcd() == NULL ? T2() : *node->getRcd());
+	}
+	gather(node->getRgt(), ids);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: FrozenStringTree
+// DESCRIPTION: Constructor of FrozenStringTree class, freezing the keys and
+//				records of an AVLTree. The tree must order its keys as
+//				std::string does, e.g. with dCmp.
+//   ARGUMENTS: const AVLTree<string, T2, Aug, Bal> &tree - the tree
+//				int block = 16 - the keys in a block
+// USES GLOBAL: none
+// MODIFIES GL: bytes, blocks, rcds, block, size
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+template<class Aug, class Bal>
+FrozenStringTree<T2>::FrozenStringTree(const AVLTree<string, T2, Aug, Bal> &tree, int block) {
+	vector<const string *> keys;
+
+	this->block = block > 0 ? block : 16;
+	gather(tree.getRoot(), keys);
+	for (size_t i = 1; i < keys.size(); i++)
+		if (!(*keys[i - 1] < *keys[i]))
+			throw AVLERR("The tree is not in string order");
+	build(keys);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find the record of a key. The block whose first key is the
+//				last one not past "id" is scanned, knowing "m", the bytes of
+//				"id" the previous key matched: a key sharing more than m
+//				bytes with the previous one is still before "id", one
+//				sharing fewer is past it, and only one sharing exactly m
+//				compares its own bytes, from the m-th on.
+//   ARGUMENTS: const string &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: const T2* - NULL if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+const T2 *FrozenStringTree<T2>::find(const string &id) const {
+	const unsigned char *q = (const unsigned char *)id.data(), *s;
+	const char *p;
+	size_t len = id.size(), n, m, l, k;
+	AVLSIZE lo = 0, hi = (AVLSIZE)blocks.size() - 1, mid, i, end;
+	int c;
+
+	if (size == 0)
+		return NULL;
+	// the last block whose first key is not past id
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		p = &bytes[blocks[mid]];
+		n = get(p);
+		c = memcmp(p, q, n < len ? n : len);
+		if (c < 0 || (c == 0 && n <= len))
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	p = &bytes[blocks[lo]];
+	n = get(p);
+	s = (const unsigned char *)p;
+	for (m = 0; m < n && m < len && s[m] == q[m]; m++);
+	if (m == n && m == len)
+		return &rcds[lo * block];
+	if (m == len || (m < n && s[m] > q[m]))
+		return NULL;	// id is before the first key
+	p += n;
+	end = (lo + 1) * block < size ? (lo + 1) * block : size;
+	for (i = lo * block + 1; i < end; i++) {
+		l = get(p);
+		n = get(p);
+		s = (const unsigned char *)p;
+		p += n;
+		if (l > m)
+			continue;
+		if (l < m)
+			return NULL;
+		for (k = 0; k < n && m + k < len && s[k] == q[m + k]; k++);
+		if (k == n && m + k == len)
+			return &rcds[i];
+		if (m + k == len || (k < n && s[k] > q[m + k]))
+			return NULL;
+		m += k;
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getKey
+// DESCRIPTION: To decode the i-th key in order.
+//   ARGUMENTS: AVLSIZE i - the rank of the key, from 0
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: string
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+string FrozenStringTree<T2>::getKey(AVLSIZE i) const {
+	const char *p;
+	string key;
+	size_t l, n;
+
+	if (i < 0 || i >= size)
+		throw AVLERR("The rank is out of range");
+	p = &bytes[blocks[i / block]];
+	n = get(p);
+	key.assign(p, n);
+	p += n;
+	for (AVLSIZE j = i / block * block; j < i; j++) {
+		l = get(p);
+		n = get(p);
+		key.resize(l);
+		key.append(p, n);
+		p += n;
+	}
+	return key;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getBytes
+// DESCRIPTION: To count the memory held by the tree.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: size_t
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T2>
+size_t FrozenStringTree<T2>::getBytes() const {
+	return sizeof(*this) + bytes.capacity() + blocks.capacity() * sizeof(size_t) +
+		rcds.capacity() * sizeof(T2);
+}
+
+#endif
@@ -0,0 +1,244 @@
+/*
+IntervalTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef INTERVALTREE_H
+#define INTERVALTREE_H
+
+#include <vector>
+#include "AVLTree.h"
+
+// A closed interval [lo, hi], ordered by lo and then by hi.
+template<class TP>
+class INTERVAL {
+public :
+	TP lo, hi;
+	INTERVAL() {}
+	INTERVAL(const TP &l, const TP &h) {
+		lo = l;
+		hi = h;
+	}
+	friend bool operator<(const INTERVAL<TP> &a, const INTERVAL<TP> &b) {
+		return a.lo < b.lo || (!(b.lo < a.lo) && a.hi < b.hi);
+	}
+	friend bool operator>(const INTERVAL<TP> &a, const INTERVAL<TP> &b) {
+		return b < a;
+	}
+};
+
+// The augmentation of an interval tree: the largest endpoint in a subtree.
+template<class TP>
+class MAXEND {
+public :
+	class value_type {
+	public :
+		bool set;	// false for an empty subtree
+		TP hi;
+		value_type() { set = false; }
+		value_type(const TP &h) {
+			set = true;
+			hi = h;
+		}
+	};
+	static value_type identity() { return value_type(); }
+	template<class T2>
+	static value_type lift(const INTERVAL<TP> &id, const T2 *rcd) { return value_type(id.hi); }
+	static value_type combine(const value_type &a, const value_type &b) {
+		if (!a.set)
+			return b;
+		if (!b.set)
+			return a;
+		return a.hi < b.hi ? b : a;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////Interval tree///////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2 = NULLT>
+class IntervalTree : public AVLTree<INTERVAL<TP>, T2, MAXEND<TP> > {
+
+private :
+	void collect(const Node<INTERVAL<TP>, T2, MAXEND<TP> > *node, const TP &lo, const TP &hi,
+		vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const;
+public :
+	using AVLTree<INTERVAL<TP>, T2, MAXEND<TP> >::Insert;
+	using AVLTree<INTERVAL<TP>, T2, MAXEND<TP> >::Delete;
+	using AVLTree<INTERVAL<TP>, T2, MAXEND<TP> >::find;
+
+	bool Insert(const TP &lo, const TP &hi);
+	bool Insert(const TP &lo, const TP &hi, const T2 &rcd);
+	bool Delete(const TP &lo, const TP &hi);
+	T2 *find(const TP &lo, const TP &hi) const;
+
+	int overlapQuery(const TP &lo, const TP &hi, vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const;
+	int stab(const TP &point, vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert the interval [lo, hi] into the interval tree.
+//   ARGUMENTS: const TP &lo - the lower endpoint
+//				const TP &hi - the upper endpoint
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+bool IntervalTree<TP, T2>::Insert(const TP &lo, const TP &hi) {
+	if (hi < lo)
+		throw AVLERR("invalid interval");
+	return this->Insert(INTERVAL<TP>(lo, hi));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert the interval [lo, hi] with its record.
+//   ARGUMENTS: const TP &lo - the lower endpoint
+//				const TP &hi - the upper endpoint
+//				const T2 &rcd - the record of the interval
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+bool IntervalTree<TP, T2>::Insert(const TP &lo, const TP &hi, const T2 &rcd) {
+	if (hi < lo)
+		throw AVLERR("invalid interval");
+	return this->Insert(INTERVAL<TP>(lo, hi), rcd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete the interval [lo, hi] from the interval tree.
+//   ARGUMENTS: const TP &lo - the lower endpoint
+//				const TP &hi - the upper endpoint
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), size
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+bool IntervalTree<TP, T2>::Delete(const TP &lo, const TP &hi) {
+	return this->Delete(INTERVAL<TP>(lo, hi));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find the record of the interval [lo, hi].
+//   ARGUMENTS: const TP &lo - the lower endpoint
+//				const TP &hi - the upper endpoint
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2*
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+T2 *IntervalTree<TP, T2>::find(const TP &lo, const TP &hi) const {
+	return this->find(INTERVAL<TP>(lo, hi));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: collect
+// DESCRIPTION: To gather inorderly the intervals of a subtree that overlap
+//				[lo, hi]. Subtrees ending before lo, starting after hi or
+//				holding only tombstones are skipped.
+//   ARGUMENTS: const Node<...> *node - the root of the subtree
+//				const TP &lo - the lower endpoint of the query
+//				const TP &hi - the upper endpoint of the query
+//				vector<const Node<...> *> &out - the output
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+void IntervalTree<TP, T2>::collect(const Node<INTERVAL<TP>, T2, MAXEND<TP> > *node, const TP &lo, const TP &hi,
+	vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const {
+	while (node != NULL && node->getAgg().set && !(node->getAgg().hi < lo)) {
+		collect(node->getLft(), lo, hi, out);
+		if (hi < node->getID().lo)
+			return;
+		if (!(node->getID().hi < lo) && !node->isDead())
+			out.push_back(node);
+		node = node->getRgt();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: overlapQuery
+// DESCRIPTION: To find all the intervals overlapping [lo, hi], in order. The
+//				cost is O(log n) plus at most O(log n) per interval found.
+//   ARGUMENTS: const TP &lo - the lower endpoint of the query
+//				const TP &hi - the upper endpoint of the query
+//				vector<const Node<...> *> &out - the nodes found are appended
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - the number of intervals found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+int IntervalTree<TP, T2>::overlapQuery(const TP &lo, const TP &hi,
+	vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const {
+	size_t before = out.size();
+	collect(this->root, lo, hi, out);
+	return (int)(out.size() - before);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: stab
+// DESCRIPTION: To find all the intervals containing a point.
+//   ARGUMENTS: const TP &point - the point
+//				vector<const Node<...> *> &out - the nodes found are appended
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - the number of intervals found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class TP, class T2>
+int IntervalTree<TP, T2>::stab(const TP &point, vector<const Node<INTERVAL<TP>, T2, MAXEND<TP> > *> &out) const {
+	return overlapQuery(point, point, out);
+}
+
+#endif
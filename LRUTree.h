@@ -0,0 +1,318 @@
+/*
+LRUTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef LRUTREE_H
+#define LRUTREE_H
+
+#include <cstddef>
+#include "AVLTree.h"
+
+// The default sizer: a record has no memory beyond the node holding it. Give
+// LRUTree a class with the same "of" for records owning heap memory, e.g.
+// one returning s.capacity() for strings.
+template<class T2>
+class RCDSIZE {
+public :
+	static size_t of(const T2 &rcd) { return 0; }
+};
+
+// A cached record, linked into the recency list of its tree. Nodes never move
+// in memory while they are in the tree, so the links point at them directly.
+template<class T1, class T2>
+class LRURCD {
+public :
+	T2 rcd;
+	size_t bytes;	// heap memory of the node, this and the record
+	Node<T1, LRURCD<T1, T2> > *newer, *older;
+	LRURCD() : rcd(), bytes(0), newer(NULL), older(NULL) {}
+	LRURCD(const T2 &r) : rcd(r), bytes(0), newer(NULL), older(NULL) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////LRU tree//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// An AVL tree with a memory budget, for caches. Every entry counts the heap
+// blocks of its node and its LRURCD, with the allocator's header and rounding,
+// plus what the sizer SZ reports for its record, and is kept on a
+// doubly linked recency list threaded through the records. Once the entries
+// use more than the budget, the least recently used ones are evicted. Moving
+// an entry to the front on a hit is O(1) on top of the lookup.
+template<class T1, class T2 = NULLT, class SZ = RCDSIZE<T2> >
+class LRUTree : protected AVLTree<T1, LRURCD<T1, T2> > {
+
+private :
+	size_t capacity;	// the budget in bytes
+	size_t used;
+	Node<T1, LRURCD<T1, T2> > *head, *tail;	// the most and least recently used
+
+	void detach(Node<T1, LRURCD<T1, T2> > *node);
+	void front(Node<T1, LRURCD<T1, T2> > *node);
+	void shrink();
+	static size_t heap(const void *p, size_t bytes);
+	LRUTree(const LRUTree &);	// the links would point into the other tree
+public :
+	LRUTree(size_t bytes) { capacity = bytes; used = 0; head = tail = NULL; }
+
+	bool Insert(const T1 &id, const T2 &rcd);
+	bool Delete(const T1 &id);
+	bool evict();
+	bool empty();
+	void setCapacity(size_t bytes) { capacity = bytes; shrink(); }
+
+	T2 *find(const T1 &id);
+	T2 *peek(const T1 &id) const;
+	bool contains(const T1 &id) const { return this->findNode(id) != NULL; }
+	const T1 *oldest() const { return tail == NULL ? NULL : &tail->getID(); }
+	size_t getCapacity() const { return capacity; }
+	size_t getBytes() const { return used; }
+	using AVLTree<T1, LRURCD<T1, T2> >::getSize;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: detach
+// DESCRIPTION: To take a node out of the recency list.
+//   ARGUMENTS: Node<T1, LRURCD<T1, T2> > *node - a node in the list
+// USES GLOBAL: none
+// MODIFIES GL: head, tail
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+void LRUTree<T1, T2, SZ>::detach(Node<T1, LRURCD<T1, T2> > *node) {
+	LRURCD<T1, T2> *e = node->getRcd();
+	if (e->newer != NULL)
+		e->newer->getRcd()->older = e->older;
+	else
+		head = e->older;
+	if (e->older != NULL)
+		e->older->getRcd()->newer = e->newer;
+	else
+		tail = e->newer;
+	e->newer = e->older = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: front
+// DESCRIPTION: To put a node not in the recency list at its front.
+//   ARGUMENTS: Node<T1, LRURCD<T1, T2> > *node - the node
+// USES GLOBAL: none
+// MODIFIES GL: head, tail
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+void LRUTree<T1, T2, SZ>::front(Node<T1, LRURCD<T1, T2> > *node) {
+	LRURCD<T1, T2> *e = node->getRcd();
+	e->newer = NULL;
+	e->older = head;
+	if (head != NULL)
+		head->getRcd()->newer = node;
+	else
+		tail = node;
+	head = node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: shrink
+// DESCRIPTION: To evict the least recently used entries until the rest fit
+//				in the budget. The most recent entry is always kept.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, used, head, tail
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+void LRUTree<T1, T2, SZ>::shrink() {
+	while (used > capacity && tail != head)
+		evict();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: heap
+// DESCRIPTION: To get the heap memory of a block: what was asked for, the
+//				allocator's rounding (see AVLSTATS::slack) and its header.
+//   ARGUMENTS: const void *p - the block
+//				size_t bytes - the size asked for
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: size_t
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+size_t LRUTree<T1, T2, SZ>::heap(const void *p, size_t bytes) {
+	return bytes + (size_t)AVLSTATS::slack(p, bytes) + sizeof(size_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert an entry as the most recently used one, and then
+//				evict the least recently used ones beyond the budget.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, used, head, tail
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+bool LRUTree<T1, T2, SZ>::Insert(const T1 &id, const T2 &rcd) {
+	LRURCD<T1, T2> entry(rcd);
+	Node<T1, LRURCD<T1, T2> > *node;
+	bool fresh;
+
+	node = this->attach(this->root, id, &entry, fresh);
+	if (!fresh)
+		return false;
+	node->getRcd()->bytes = heap(node, sizeof(Node<T1, LRURCD<T1, T2> >))
+		+ heap(node->getRcd(), sizeof(LRURCD<T1, T2>)) + SZ::of(rcd);
+	used += node->getRcd()->bytes;
+	front(node);
+	shrink();
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete an entry.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, used, head, tail
+//     RETURNS: bool - false if the key is not in the tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+bool LRUTree<T1, T2, SZ>::Delete(const T1 &id) {
+	Node<T1, LRURCD<T1, T2> > *node =
+		const_cast<Node<T1, LRURCD<T1, T2> > *>(this->findNode(id));
+	if (node == NULL)
+		return false;
+	detach(node);
+	used -= node->getRcd()->bytes;
+	this->unlink(node);
+	delete node;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: evict
+// DESCRIPTION: To delete the least recently used entry.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size, used, head, tail
+//     RETURNS: bool - false if the tree is empty
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+bool LRUTree<T1, T2, SZ>::evict() {
+	Node<T1, LRURCD<T1, T2> > *node = tail;
+	if (node == NULL)
+		return false;
+	detach(node);
+	used -= node->getRcd()->bytes;
+	this->unlink(node);
+	delete node;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: empty
+// DESCRIPTION: To delete all the entries.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: root, finger, size, used, head, tail
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+bool LRUTree<T1, T2, SZ>::empty() {
+	used = 0;
+	head = tail = NULL;
+	return AVLTree<T1, LRURCD<T1, T2> >::empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find the record of an entry and make it the most recently
+//				used one.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: head, tail
+//     RETURNS: T2* - NULL if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+T2 *LRUTree<T1, T2, SZ>::find(const T1 &id) {
+	Node<T1, LRURCD<T1, T2> > *node =
+		const_cast<Node<T1, LRURCD<T1, T2> > *>(this->findNode(id));
+	if (node == NULL)
+		return NULL;
+	if (node != head) {
+		detach(node);
+		front(node);
+	}
+	return &node->getRcd()->rcd;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: peek
+// DESCRIPTION: To find the record of an entry without touching its recency.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2* - NULL if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class SZ>
+T2 *LRUTree<T1, T2, SZ>::peek(const T1 &id) const {
+	const Node<T1, LRURCD<T1, T2> > *node = this->findNode(id);
+	return node == NULL ? NULL : &node->getRcd()->rcd;
+}
+
+#endif
@@ -0,0 +1,496 @@
+/*
+ReplicatedAVLTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef REPLICATEDAVLTREE_H
+#define REPLICATEDAVLTREE_H
+
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include "AVLTree.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Reads a Linux cpu or node list such as "0-7,16-23" into "out", marking
+// every number in it with "mark". Returns the largest number, -1 for none.
+inline int numaList(const char *file, vector<int> &out, int mark) {
+	FILE *f = fopen(file, "r");
+	int lo, hi, top = -1;
+	char sep;
+	if (f == NULL)
+		return -1;
+	while (fscanf(f, "%d", &lo) == 1) {
+		hi = lo;
+		if (fscanf(f, "%c", &sep) == 1 && sep == '-' && fscanf(f, "%d", &hi) == 1)
+			fscanf(f, "%c", &sep);
+		for (int i = lo; i <= hi; i++) {
+			if ((int)out.size() <= i)
+				out.resize(i + 1, 0);
+			out[i] = mark;
+		}
+		top = hi > top ? hi : top;
+	}
+	fclose(f);
+	return top;
+}
+
+// One logged write, to be applied to every replica in order.
+template<class T1, class T2>
+class REPOP {
+public :
+	char op;	// 'I' insert, 'M' modify, 'D' delete
+	T1 id;
+	T2 rcd;
+	int owner;	// the replica of the writer, the one to report the result
+	bool *done;	// where to report it, under the owner's lock
+};
+
+// One copy of the tree with its own lock and the log position it reached.
+template<class T1, class T2, class Aug, class Bal>
+class alignas(64) REPLICA {
+public :
+	AVLTree<T1, T2, Aug, Bal> tree;
+	mutable std::shared_mutex lock;
+	std::atomic<long long> applied;
+	REPLICA() : applied(0) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////Replicated AVL tree////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// A read-mostly AVL tree with one replica per NUMA node, in the style of node
+// replication. A write is appended to a shared log and applied to the
+// writer's own replica; every other replica replays the log when one of its
+// own threads next touches it. So the nodes of a replica are allocated, and
+// first touched, by threads of its node, and each lookup stays in local
+// memory. The same writes in the same order give every replica the same
+// answers, so the result of a write comes from any one of them.
+//
+// A replica that no thread visits would hold the log back, so once the log
+// is longer than "limit" a writer wakes a helper thread per replica, pinned
+// to the cpus of the replica's node, and waits for them to bring every
+// replica up to date. The writer never applies the log to another node's
+// replica, which would place its nodes on the writer's node. On a machine with one NUMA node, or off Linux, there is a single replica
+// unless more are asked for, which tests the replication anywhere.
+template<class T1, class T2 = NULLT, class Aug = NOAUG, class Bal = AVLBAL>
+class ReplicatedAVLTree {
+
+private :
+	REPLICA<T1, T2, Aug, Bal> *reps;
+	int n;
+	vector<int> nodeOf;	// the NUMA node of every cpu
+	std::mutex logLock;
+	std::deque<REPOP<T1, T2> > log;
+	long long base;	// the log position of log[0]
+	std::atomic<long long> tail;	// the log position after the last write
+	long long limit;
+	std::mutex helpLock;
+	std::condition_variable wake;	// "want" was raised, or closing
+	std::condition_variable caught;	// a helper brought its replica up to date
+	std::vector<std::thread> helpers;	// one per replica, none for one replica
+	long long want;	// the log position every replica is asked to reach
+	bool closing;
+
+	void catchUp(int r, long long upto);
+	bool write(char op, const T1 &id, const T2 &rcd, int r);
+	void trim();
+	void help(int r);
+	ReplicatedAVLTree(const ReplicatedAVLTree &);
+public :
+	ReplicatedAVLTree(int replicas = 0, int(*compare)(const T1 &a, const T1 &b) = dCmp, long long limit = 4096);
+	~ReplicatedAVLTree();
+
+	bool Insert(const T1 &id) { return write('I', id, T2(), -1); }
+	bool Insert(const T1 &id, const T2 &rcd, int r = -1) { return write('I', id, rcd, r); }
+	bool Modify(const T1 &id, const T2 &rcd, int r = -1) { return write('M', id, rcd, r); }
+	bool Delete(const T1 &id, int r = -1) { return write('D', id, T2(), r); }
+	bool find(const T1 &id, T2 &rcd, int r = -1);
+	bool contains(const T1 &id, int r = -1);
+	AVLSIZE getSize(int r = -1);
+
+	int local() const;
+	int getReplicas() const { return n; }
+	static int numaNodes();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: numaNodes
+// DESCRIPTION: To count the NUMA nodes of the machine.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int - 1 where it cannot be told
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+int ReplicatedAVLTree<T1, T2, Aug, Bal>::numaNodes() {
+	vector<int> nodes;
+	int top = numaList("/sys/devices/system/node/online", nodes, 1);
+	return top < 0 ? 1 : top + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ReplicatedAVLTree
+// DESCRIPTION: Constructor of ReplicatedAVLTree class. It maps every cpu to
+//				its NUMA node so that a thread can find its local replica,
+//				and starts the helpers of a tree with more than one replica.
+//   ARGUMENTS: int replicas = 0 - the number of replicas, 0 for one per node
+//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//				long long limit = 4096 - the log length at which a writer
+//				has the helpers update all the replicas
+// USES GLOBAL: none
+// MODIFIES GL: reps, n, nodeOf, base, tail, limit, want, closing, helpers
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+ReplicatedAVLTree<T1, T2, Aug, Bal>::ReplicatedAVLTree(int replicas, int(*compare)(const T1 &a, const T1 &b), long long limit) {
+	char file[64];
+	int nodes = numaNodes();
+	n = replicas > 0 ? replicas : nodes;
+	reps = new REPLICA<T1, T2, Aug, Bal>[n];
+	for (int i = 0; i < n; i++)
+		reps[i].tree.setCmp(compare);
+	for (int node = 0; node < nodes; node++) {
+		sprintf(file, "/sys/devices/system/node/node%d/cpulist", node);
+		numaList(file, nodeOf, node);
+	}
+	base = 0;
+	tail = 0;
+	this->limit = limit > 0 ? limit : 1;
+	want = 0;
+	closing = false;
+	for (int i = 0; n > 1 && i < n; i++)
+		helpers.push_back(std::thread(&ReplicatedAVLTree<T1, T2, Aug, Bal>::help, this, i));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ~ReplicatedAVLTree
+// DESCRIPTION: Destructor of ReplicatedAVLTree class. It stops the helpers.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: closing, helpers, reps
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+ReplicatedAVLTree<T1, T2, Aug, Bal>::~ReplicatedAVLTree() {
+	{
+		std::lock_guard<std::mutex> hold(helpLock);
+		closing = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < helpers.size(); i++)
+		helpers[i].join();
+	delete[] reps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: local
+// DESCRIPTION: To find the replica of the calling thread's NUMA node.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+int ReplicatedAVLTree<T1, T2, Aug, Bal>::local() const {
+#ifdef __linux__
+	int cpu = sched_getcpu();
+	if (cpu >= 0 && cpu < (int)nodeOf.size())
+		return nodeOf[cpu] % n;
+#endif
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: catchUp
+// DESCRIPTION: To apply the log to replica r up to the position "upto", and
+//				report the results of the writes made through it. The
+//				caller holds the replica's lock exclusively.
+//   ARGUMENTS: int r - the replica
+//				long long upto - the log position to stop before
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+void ReplicatedAVLTree<T1, T2, Aug, Bal>::catchUp(int r, long long upto) {
+	REPLICA<T1, T2, Aug, Bal> &rep = reps[r];
+	vector<REPOP<T1, T2> > ops;
+	long long from = rep.applied.load();
+	bool done = false;
+
+	if (from >= upto)
+		return;
+	{
+		std::lock_guard<std::mutex> hold(logLock);
+		ops.assign(log.begin() + (from - base), log.begin() + (upto - base));
+	}
+	for (size_t i = 0; i < ops.size(); i++) {
+		if (ops[i].op == 'I')
+			done = rep.tree.Insert(ops[i].id, ops[i].rcd);
+		else if (ops[i].op == 'M')
+			done = rep.tree.Modify(ops[i].id, ops[i].rcd);
+		else
+			done = rep.tree.Delete(ops[i].id);
+		if (ops[i].owner == r)
+			*ops[i].done = done;
+	}
+	rep.applied.store(upto);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: trim
+// DESCRIPTION: To drop the head of the log that every replica has applied.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: log, base
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+void ReplicatedAVLTree<T1, T2, Aug, Bal>::trim() {
+	long long least = tail.load();
+
+	for (int i = 0; i < n; i++)
+		if (reps[i].applied.load() < least)
+			least = reps[i].applied.load();
+
+	std::lock_guard<std::mutex> hold(logLock);
+	while (base < least) {
+		log.pop_front();
+		++base;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: help
+// DESCRIPTION: The helper thread of replica r. It pins itself to the cpus of
+//				the replica's node, so that the nodes it allocates are first
+//				touched there, then brings the replica up to the log tail
+//				whenever a writer raises "want" past it. Where no cpu maps to
+//				the replica, or the pinning is refused, it runs where it is
+//				scheduled.
+//   ARGUMENTS: int r - the replica
+// USES GLOBAL: none
+// MODIFIES GL: reps
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+void ReplicatedAVLTree<T1, T2, Aug, Bal>::help(int r) {
+#ifdef __linux__
+	cpu_set_t cpus;
+	bool any = false;
+	CPU_ZERO(&cpus);
+	for (int cpu = 0; cpu < (int)nodeOf.size() && cpu < CPU_SETSIZE; cpu++)
+		if (nodeOf[cpu] % n == r) {
+			CPU_SET(cpu, &cpus);
+			any = true;
+		}
+	if (any)
+		sched_setaffinity(0, sizeof(cpus), &cpus);
+#endif
+	std::unique_lock<std::mutex> hold(helpLock);
+	while (!closing) {
+		if (reps[r].applied.load() >= want) {
+			// a reader of the replica may have caught it up instead
+			caught.notify_all();
+			wake.wait(hold);
+			continue;
+		}
+		hold.unlock();
+		{
+			std::unique_lock<std::shared_mutex> rep(reps[r].lock);
+			catchUp(r, tail.load());
+		}
+		hold.lock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: write
+// DESCRIPTION: To log a write and apply the log up to it to replica r. A
+//				log past its limit has the helpers update every replica,
+//				and waits for them, before it is trimmed.
+//   ARGUMENTS: char op - 'I' insert, 'M' modify or 'D' delete
+//				const T1 &id - the key
+//				const T2 &rcd - the record, unused by 'D'
+//				int r - the replica, -1 for the local one
+// USES GLOBAL: none
+// MODIFIES GL: log, tail, want
+//     RETURNS: bool - the result of the write, as in AVLTree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ReplicatedAVLTree<T1, T2, Aug, Bal>::write(char op, const T1 &id, const T2 &rcd, int r) {
+	REPOP<T1, T2> entry;
+	long long at, behind;
+	bool done = false;
+
+	if (r < 0 || r >= n)
+		r = local();
+	entry.op = op;
+	entry.id = id;
+	entry.rcd = rcd;
+	entry.owner = r;
+	entry.done = &done;
+	{
+		std::lock_guard<std::mutex> hold(logLock);
+		log.push_back(entry);
+		at = tail.load() + 1;
+		tail.store(at);
+		behind = at - base;
+	}
+	{
+		// a reader or writer of the same replica may have applied it first
+		std::unique_lock<std::shared_mutex> hold(reps[r].lock);
+		catchUp(r, at);
+	}
+	if (behind > limit && n > 1) {
+		std::unique_lock<std::mutex> hold(helpLock);
+		want = want > at ? want : at;
+		wake.notify_all();
+		for (int i = 0; i < n; i++)
+			while (reps[i].applied.load() < at)
+				caught.wait(hold);
+	}
+	if (behind > limit || (at & 255) == 0)
+		trim();
+	return done;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To copy out the record of a key from replica r, once it has
+//				applied every write logged before the call.
+//   ARGUMENTS: const T1 &id - the key
+//				T2 &rcd - receives the record
+//				int r = -1 - the replica, -1 for the local one
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - false if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ReplicatedAVLTree<T1, T2, Aug, Bal>::find(const T1 &id, T2 &rcd, int r) {
+	long long upto = tail.load();
+	T2 *p;
+
+	if (r < 0 || r >= n)
+		r = local();
+	if (reps[r].applied.load() < upto) {
+		std::unique_lock<std::shared_mutex> hold(reps[r].lock);
+		catchUp(r, upto);
+	}
+	std::shared_lock<std::shared_mutex> hold(reps[r].lock);
+	p = reps[r].tree.find(id);
+	if (p != NULL)
+		rcd = *p;
+	return p != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: contains
+// DESCRIPTION: To check whether a key is in the tree, as find does.
+//   ARGUMENTS: const T1 &id - the key
+//				int r = -1 - the replica, -1 for the local one
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ReplicatedAVLTree<T1, T2, Aug, Bal>::contains(const T1 &id, int r) {
+	long long upto = tail.load();
+	if (r < 0 || r >= n)
+		r = local();
+	if (reps[r].applied.load() < upto) {
+		std::unique_lock<std::shared_mutex> hold(reps[r].lock);
+		catchUp(r, upto);
+	}
+	std::shared_lock<std::shared_mutex> hold(reps[r].lock);
+	return reps[r].tree.contains(id);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: getSize
+// DESCRIPTION: To count the keys, as find sees them.
+//   ARGUMENTS: int r = -1 - the replica, -1 for the local one
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLSIZE
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+AVLSIZE ReplicatedAVLTree<T1, T2, Aug, Bal>::getSize(int r) {
+	long long upto = tail.load();
+	if (r < 0 || r >= n)
+		r = local();
+	if (reps[r].applied.load() < upto) {
+		std::unique_lock<std::shared_mutex> hold(reps[r].lock);
+		catchUp(r, upto);
+	}
+	std::shared_lock<std::shared_mutex> hold(reps[r].lock);
+	return reps[r].tree.getSize();
+}
+
+#endif
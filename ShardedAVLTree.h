@@ -0,0 +1,581 @@
+/*
+ShardedAVLTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef SHARDEDAVLTREE_H
+#define SHARDEDAVLTREE_H
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include "AVLTree.h"
+
+template<typename T1>
+size_t dHash(const T1 &id) {
+	return std::hash<T1>()(id);
+}
+
+// One shard: an AVL tree with its own lock, alone on its cache lines so that
+// threads working on different shards do not share any. Under range sharding
+// it takes the keys in [lo, hi), the bounds changing only under its lock.
+template<class T1, class T2, class Aug, class Bal>
+class alignas(64) SHARD : public AVLTree<T1, T2, Aug, Bal> {
+public :
+	mutable std::mutex lock;
+	T1 lo, hi;
+	bool hasLo, hasHi;	// false for no bound
+	SHARD() : lo(), hi() { hasLo = hasHi = false; }
+
+	Node<T1, T2, Aug, Bal> *first() const {
+		Node<T1, T2, Aug, Bal> *p = this->root;
+		while (p != NULL && p->getLft() != NULL)
+			p = p->getLft();
+		return p;
+	}
+	Node<T1, T2, Aug, Bal> *last() const {
+		Node<T1, T2, Aug, Bal> *p = this->root;
+		while (p != NULL && p->getRgt() != NULL)
+			p = p->getRgt();
+		return p;
+	}
+	bool covers(const T1 &id) const {
+		return (!hasLo || this->cmp(lo, id) <= 0) && (!hasHi || this->cmp(id, hi) < 0);
+	}
+};
+
+// The readers of the bound snapshots of one group of threads, counted by the
+// parity of the epoch they started in, alone on a cache line.
+class alignas(64) READERS {
+public :
+	std::atomic<int> in[2];
+	READERS() { in[0] = in[1] = 0; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////Sharded AVL tree////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// The key space split over several AVL trees, each behind its own lock, so
+// that writers on different shards run in parallel. Hash sharding spreads any
+// workload evenly; range sharding keeps every shard a contiguous key range, so
+// ordered walks need no merge, and rebalance moves the edge of a hot range to
+// its neighbour while the tree stays in use.
+//
+// Under range sharding an operation routes by a snapshot of the bounds, then
+// checks the locked shard's own range and routes again if a rebalance moved
+// it in between. A snapshot is never changed once published. Readers count
+// themselves in the parity of the current epoch while they hold one, and
+// rebalance frees the old ones before it returns, once it has flipped the
+// epoch twice and seen each parity drain of readers, as userspace RCU does.
+template<class T1, class T2 = NULLT, class Aug = NOAUG, class Bal = AVLBAL>
+class ShardedAVLTree {
+
+private :
+	SHARD<T1, T2, Aug, Bal> *shards;
+	int n;
+	int(*cmp)(const T1 &a, const T1 &b);
+	size_t(*hasher)(const T1 &id);	// NULL under range sharding
+	std::atomic<const vector<T1> *> bounds;	// the lowest key of shards 1 to n-1
+	vector<const vector<T1> *> retired;	// replaced, freed by reclaim
+	mutable READERS readers[16];
+	std::atomic<int> epoch;
+	std::mutex moving;	// one rebalance at a time
+	std::atomic<AVLSIZE> count;
+
+	SHARD<T1, T2, Aug, Bal> *acquire(const T1 &id) const;
+	AVLSIZE shift(int i, AVLSIZE m);
+	void reclaim();
+	static int slot();
+	ShardedAVLTree(const ShardedAVLTree &);
+public :
+	ShardedAVLTree(int shards, int(*compare)(const T1 &a, const T1 &b) = dCmp, size_t(*hash)(const T1 &id) = dHash);
+	ShardedAVLTree(const vector<T1> &splits, int(*compare)(const T1 &a, const T1 &b) = dCmp);
+	~ShardedAVLTree();
+
+	bool Insert(const T1 &id);
+	bool Insert(const T1 &id, const T2 &rcd);
+	bool Delete(const T1 &id);
+	bool find(const T1 &id, T2 &rcd) const;
+	bool contains(const T1 &id) const;
+	template<class F> AVLSIZE inorder(F visit) const;
+	AVLSIZE rebalance(int chunk = 1024);
+
+	AVLSIZE getSize() const { return count.load(); }
+	int getShards() const { return n; }
+	AVLSIZE shardSize(int i) const;
+	bool byRange() const { return hasher == NULL; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ShardedAVLTree
+// DESCRIPTION: Constructor of a hash sharded tree.
+//   ARGUMENTS: int shards - the number of shards
+//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+//				size_t(*hash)(const T1 &id) = dHash - the hash that picks a shard
+// USES GLOBAL: none
+// MODIFIES GL: shards, n, cmp, hasher, bounds, epoch, count
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+ShardedAVLTree<T1, T2, Aug, Bal>::ShardedAVLTree(int shards, int(*compare)(const T1 &a, const T1 &b), size_t(*hash)(const T1 &id)) {
+	if (shards < 1)
+		throw AVLERR("no shards");
+	n = shards;
+	this->shards = new SHARD<T1, T2, Aug, Bal>[n];
+	for (int i = 0; i < n; i++)
+		this->shards[i].setCmp(compare);
+	cmp = compare;
+	hasher = hash;
+	bounds = NULL;
+	epoch = 0;
+	count = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ShardedAVLTree
+// DESCRIPTION: Constructor of a range sharded tree. Shard i takes the keys
+//				from splits[i - 1] up to before splits[i].
+//   ARGUMENTS: const vector<T1> &splits - the increasing bounds between shards
+//				int(*compare)(const T1 &a, const T1 &b) = dCmp - the compare function
+// USES GLOBAL: none
+// MODIFIES GL: shards, n, cmp, hasher, bounds, epoch, count
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+ShardedAVLTree<T1, T2, Aug, Bal>::ShardedAVLTree(const vector<T1> &splits, int(*compare)(const T1 &a, const T1 &b)) {
+	for (size_t i = 1; i < splits.size(); i++)
+		if (compare(splits[i - 1], splits[i]) >= 0)
+			throw AVLERR("splits are not increasing");
+	n = (int)splits.size() + 1;
+	shards = new SHARD<T1, T2, Aug, Bal>[n];
+	for (int i = 0; i < n; i++) {
+		shards[i].setCmp(compare);
+		if (i > 0) {
+			shards[i].lo = splits[i - 1];
+			shards[i].hasLo = true;
+		}
+		if (i < n - 1) {
+			shards[i].hi = splits[i];
+			shards[i].hasHi = true;
+		}
+	}
+	cmp = compare;
+	hasher = NULL;
+	bounds = new vector<T1>(splits);
+	epoch = 0;
+	count = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: ~ShardedAVLTree
+// DESCRIPTION: Destructor of ShardedAVLTree class.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: shards, bounds, retired
+//     RETURNS: none
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+ShardedAVLTree<T1, T2, Aug, Bal>::~ShardedAVLTree() {
+	delete[] shards;
+	delete bounds.load();
+	for (size_t i = 0; i < retired.size(); i++)
+		delete retired[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: acquire
+// DESCRIPTION: To lock the shard that takes the key "id".
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: SHARD<T1, T2, Aug, Bal>* - the shard, locked by the caller's thread
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+SHARD<T1, T2, Aug, Bal> *ShardedAVLTree<T1, T2, Aug, Bal>::acquire(const T1 &id) const {
+	const vector<T1> *b;
+	READERS &mine = readers[slot()];
+	int lo, hi, mid, e;
+
+	if (hasher != NULL) {
+		lo = (int)(hasher(id) % n);
+		shards[lo].lock.lock();
+		return &shards[lo];
+	}
+	for (;;) {
+		// the first bound after id is the index of its shard
+		e = epoch.load();
+		mine.in[e].fetch_add(1);
+		b = bounds.load();
+		lo = 0;
+		hi = (int)b->size();
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (cmp(id, (*b)[mid]) < 0)
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		mine.in[e].fetch_sub(1);	// before locking, as reclaim waits under no lock
+		shards[lo].lock.lock();
+		if (shards[lo].covers(id))
+			return &shards[lo];
+		shards[lo].lock.unlock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a key into its shard.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: count
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ShardedAVLTree<T1, T2, Aug, Bal>::Insert(const T1 &id) {
+	SHARD<T1, T2, Aug, Bal> *s = acquire(id);
+	bool fresh = s->Insert(id);
+	s->lock.unlock();
+	if (fresh)
+		++count;
+	return fresh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert a key with its record into its shard.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+// USES GLOBAL: none
+// MODIFIES GL: count
+//     RETURNS: bool - false if the key is in the tree already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ShardedAVLTree<T1, T2, Aug, Bal>::Insert(const T1 &id, const T2 &rcd) {
+	SHARD<T1, T2, Aug, Bal> *s = acquire(id);
+	bool fresh = s->Insert(id, rcd);
+	s->lock.unlock();
+	if (fresh)
+		++count;
+	return fresh;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Delete
+// DESCRIPTION: To delete a key from its shard.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: count
+//     RETURNS: bool - false if the key is not in the tree
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ShardedAVLTree<T1, T2, Aug, Bal>::Delete(const T1 &id) {
+	SHARD<T1, T2, Aug, Bal> *s = acquire(id);
+	bool found = s->Delete(id);
+	s->lock.unlock();
+	if (found)
+		--count;
+	return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To copy out the record of a key. A pointer into a shard would
+//				not outlive its lock, so the record is copied under it.
+//   ARGUMENTS: const T1 &id - the key
+//				T2 &rcd - receives the record
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - false if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ShardedAVLTree<T1, T2, Aug, Bal>::find(const T1 &id, T2 &rcd) const {
+	SHARD<T1, T2, Aug, Bal> *s = acquire(id);
+	T2 *p = s->find(id);
+	if (p != NULL)
+		rcd = *p;
+	s->lock.unlock();
+	return p != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: contains
+// DESCRIPTION: To check whether a key is in the tree.
+//   ARGUMENTS: const T1 &id - the key
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+bool ShardedAVLTree<T1, T2, Aug, Bal>::contains(const T1 &id) const {
+	SHARD<T1, T2, Aug, Bal> *s = acquire(id);
+	bool found = s->contains(id);
+	s->lock.unlock();
+	return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: shardSize
+// DESCRIPTION: To count the keys of one shard.
+//   ARGUMENTS: int i - the index of the shard
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLSIZE
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+AVLSIZE ShardedAVLTree<T1, T2, Aug, Bal>::shardSize(int i) const {
+	std::lock_guard<std::mutex> hold(shards[i].lock);
+	return shards[i].getSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: inorder
+// DESCRIPTION: To visit all the nodes in global order, calling visit(node)
+//				on each. Range shards are walked one after another; hash
+//				shards are merged k ways by a heap of their next nodes. All
+//				the shards are locked, in index order, for the whole walk.
+//   ARGUMENTS: F visit - called with a const Node<T1, T2, Aug, Bal>* per node
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: AVLSIZE - the number of nodes visited
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+template<class F>
+AVLSIZE ShardedAVLTree<T1, T2, Aug, Bal>::inorder(F visit) const {
+	vector<const Node<T1, T2, Aug, Bal> *> heap;
+	const Node<T1, T2, Aug, Bal> *p;
+	int(*order)(const T1 &a, const T1 &b) = cmp;
+	AVLSIZE seen = 0;
+	int i;
+
+	for (i = 0; i < n; i++)
+		shards[i].lock.lock();
+	if (hasher == NULL) {
+		for (i = 0; i < n; i++)
+			for (p = shards[i].first(); p != NULL; p = p->next(), ++seen)
+				visit(p);
+	}
+	else {
+		// a min-heap on the IDs, hence the reversed comparison
+		auto later = [order](const Node<T1, T2, Aug, Bal> *a, const Node<T1, T2, Aug, Bal> *b) {
+			return order(a->getID(), b->getID()) > 0;
+		};
+		for (i = 0; i < n; i++)
+			if ((p = shards[i].first()) != NULL)
+				heap.push_back(p);
+		make_heap(heap.begin(), heap.end(), later);
+		while (!heap.empty()) {
+			pop_heap(heap.begin(), heap.end(), later);
+			p = heap.back();
+			visit(p);
+			++seen;
+			if ((heap.back() = p->next()) != NULL)
+				push_heap(heap.begin(), heap.end(), later);
+			else
+				heap.pop_back();
+		}
+	}
+	for (i = n - 1; i >= 0; i--)
+		shards[i].lock.unlock();
+	return seen;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: shift
+// DESCRIPTION: To move keys across the bound between range shards i and
+//				i + 1: the m largest of shard i to the right if m > 0, the -m
+//				smallest of shard i + 1 to the left if m < 0, as many as there
+//				are while shard i + 1 keeps one to mark the bound. The nodes
+//				are moved whole with extract and InsertNode, and the new
+//				bound is published before the two locks are released.
+//   ARGUMENTS: int i - the shard left of the bound
+//				AVLSIZE m - the keys to move, signed by direction
+// USES GLOBAL: none
+// MODIFIES GL: bounds, retired
+//     RETURNS: AVLSIZE - the keys moved, signed as m
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+AVLSIZE ShardedAVLTree<T1, T2, Aug, Bal>::shift(int i, AVLSIZE m) {
+	SHARD<T1, T2, Aug, Bal> &L = shards[i], &R = shards[i + 1];
+	std::lock_guard<std::mutex> holdL(L.lock), holdR(R.lock);
+	vector<T1> *next;
+	AVLSIZE k;
+
+	if (m > L.getSize())
+		m = L.getSize();
+	if (m < 0 && -m > R.getSize() - 1)
+		m = R.getSize() > 0 ? 1 - R.getSize() : 0;
+	if (m == 0)
+		return 0;
+	for (k = 0; k < m; k++)
+		R.InsertNode(L.extract(L.last()->getID()));
+	for (k = 0; k < -m; k++)
+		L.InsertNode(R.extract(R.first()->getID()));
+	R.lo = L.hi = R.first()->getID();
+
+	next = new vector<T1>(*bounds.load());
+	(*next)[i] = R.lo;
+	retired.push_back(bounds.load());
+	bounds.store(next);
+	return m;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: reclaim
+// DESCRIPTION: To free the retired snapshots of the bounds. The epoch is
+//				flipped and the readers that started in the old parity are
+//				waited for, twice, so that every reader that could have
+//				loaded a retired snapshot has finished. New readers load the
+//				current one and are never waited for.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: epoch, retired
+//     RETURNS: void
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+void ShardedAVLTree<T1, T2, Aug, Bal>::reclaim() {
+	int e;
+	if (retired.empty())
+		return;
+	for (int flip = 0; flip < 2; flip++) {
+		e = epoch.load();
+		epoch.store(1 - e);
+		for (int i = 0; i < 16; i++)
+			while (readers[i].in[e].load() != 0)
+				std::this_thread::yield();
+	}
+	for (size_t i = 0; i < retired.size(); i++)
+		delete retired[i];
+	retired.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: slot
+// DESCRIPTION: To get the reader slot of the calling thread. Threads take the
+//				slots in turn, so that few of them share a cache line.
+//   ARGUMENTS: none
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: int
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+int ShardedAVLTree<T1, T2, Aug, Bal>::slot() {
+	static std::atomic<int> next(0);
+	thread_local int mine = next.fetch_add(1) % 16;
+	return mine;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: rebalance
+// DESCRIPTION: To move every bound between range shards toward an even share
+//				of the keys, by at most "chunk" keys each. Only two shards
+//				are locked at a time, so the others keep serving; call it
+//				repeatedly, e.g. from a background thread, to follow a hot
+//				range. Bounds within an eighth of a share are left alone.
+//				The replaced snapshots of the bounds are freed before it
+//				returns, so repeated calls hold no more memory.
+//   ARGUMENTS: int chunk = 1024 - the most keys to move across a bound
+// USES GLOBAL: none
+// MODIFIES GL: bounds, retired, epoch
+//     RETURNS: AVLSIZE - the number of keys moved, 0 under hash sharding
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class Aug, class Bal>
+AVLSIZE ShardedAVLTree<T1, T2, Aug, Bal>::rebalance(int chunk) {
+	std::lock_guard<std::mutex> hold(moving);
+	vector<AVLSIZE> sizes(n);
+	AVLSIZE total = 0, left = 0, want, moved = 0, m;
+	int i;
+
+	if (hasher != NULL)
+		return 0;
+	for (i = 0; i < n; i++)
+		total += sizes[i] = shardSize(i);
+	for (i = 0; i + 1 < n; i++) {
+		// the keys left of bound i beyond an even share
+		left += sizes[i];
+		want = left - total * (i + 1) / n;
+		if (want <= total / n / 8 && -want <= total / n / 8)
+			continue;
+		want = want > chunk ? chunk : want < -chunk ? -chunk : want;
+		m = shift(i, want);
+		sizes[i] -= m;
+		sizes[i + 1] += m;
+		left -= m;
+		moved += m < 0 ? -m : m;
+	}
+	reclaim();
+	return moved;
+}
+
+#endif
@@ -0,0 +1,195 @@
+/*
+TTLTree.h
+
+Copyright (C) 2026 agent <agent@local>
+
+Built on AVLTree.h, Copyright (C) 2015-2019 Kingston Chan.
+
+This source code is provided 'as-is', without any express or implied
+warranty. In no event will the author be held liable for any damages
+arising from the use of this code.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it
+freely, subject to the following restrictions:
+
+1. The origin of this source code must not be misrepresented; you must not
+claim that you wrote the original source code. If you use this source code
+in a product, an acknowledgment in the product documentation would be
+appreciated but is not required.
+
+2. Altered source versions must be plainly marked as such, and must not be
+misrepresented as being the original source code.
+
+3. This notice may not be removed or altered from any source distribution.
+
+agent <agent@local>
+
+*/
+
+#ifndef TTLTREE_H
+#define TTLTREE_H
+
+#include <limits>
+#include "AVLTree.h"
+
+// A cached record with the time it expires at.
+template<class T2, class TM>
+class TTLRCD {
+public :
+	T2 rcd;
+	TM expires;
+	TTLRCD() : rcd(), expires() {}
+	TTLRCD(const T2 &r, const TM &e) : rcd(r), expires(e) {}
+};
+
+// The augmentation of a TTL tree: the earliest expiry in a subtree.
+template<class T2, class TM>
+class MINEXP {
+public :
+	typedef TM value_type;
+	static TM identity() { return numeric_limits<TM>::max(); }
+	template<class T1>
+	static TM lift(const T1 &id, const TTLRCD<T2, TM> *rcd) { return rcd->expires; }
+	static TM combine(const TM &a, const TM &b) { return b < a ? b : a; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////TTL tree//////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////
+// An AVL tree of cached entries ordered by key, where every subtree also knows
+// its earliest expiry. An expired entry is found from the root in O(log n)
+// without scanning, so eviction is bounded and can run a little on every
+// Insert. Entries past their expiry but not evicted yet are never returned.
+template<class T1, class T2 = NULLT, class TM = long long>
+class TTLTree : protected AVLTree<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > {
+
+private :
+	int sweep;	// the expired entries evicted on every Insert at most
+public :
+	TTLTree(int budget = 2) { sweep = budget; }
+
+	bool Insert(const T1 &id, const T2 &rcd, const TM &expires, const TM &now);
+	bool touch(const T1 &id, const TM &expires);
+	int evictExpired(const TM &now, int budget);
+	T2 *find(const T1 &id, const TM &now) const;
+
+	using AVLTree<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> >::Delete;
+	using AVLTree<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> >::empty;
+	using AVLTree<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> >::getSize;
+	TM nextExpiry() const { return this->root == NULL ? MINEXP<T2, TM>::identity() : this->root->getAgg(); }
+	void setSweep(int budget) { sweep = budget; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: Insert
+// DESCRIPTION: To insert an entry that expires at "expires", and then evict
+//				a few expired entries. An expired entry of the same key is
+//				replaced; a live one is left as it is.
+//   ARGUMENTS: const T1 &id - the key
+//				const T2 &rcd - the record
+//				const TM &expires - the time the entry expires at
+//				const TM &now - the current time
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: bool - false if a live entry of the key exists already
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class TM>
+bool TTLTree<T1, T2, TM>::Insert(const T1 &id, const T2 &rcd, const TM &expires, const TM &now) {
+	TTLRCD<T2, TM> entry(rcd, expires);
+	Node<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > *node;
+	bool fresh;
+
+	node = this->attach(this->root, id, &entry, fresh);
+	if (!fresh) {
+		if (now < node->getRcd()->expires)
+			return false;
+		*node->getRcd() = entry;
+		this->refresh(node);
+	}
+	evictExpired(now, sweep);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: touch
+// DESCRIPTION: To move the expiry of an entry, e.g. on a cache hit.
+//   ARGUMENTS: const T1 &id - the key
+//				const TM &expires - the new time the entry expires at
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: bool - false if the key is not found
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class TM>
+bool TTLTree<T1, T2, TM>::touch(const T1 &id, const TM &expires) {
+	Node<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > *node =
+		const_cast<Node<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > *>(this->findNode(id));
+	if (node == NULL)
+		return false;
+	node->getRcd()->expires = expires;
+	this->refresh(node);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: evictExpired
+// DESCRIPTION: To delete at most "budget" entries that expired by "now". Every
+//				one is found by following the earliest expiry down from the
+//				root, O(log n) each.
+//   ARGUMENTS: const TM &now - the current time
+//				int budget - the most entries to evict, negative for no bound
+// USES GLOBAL: none
+// MODIFIES GL: root (possible), finger, size
+//     RETURNS: int - the number of entries evicted
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class TM>
+int TTLTree<T1, T2, TM>::evictExpired(const TM &now, int budget) {
+	Node<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > *p;
+	int n = 0;
+	while (n != budget && this->root != NULL && !(now < this->root->getAgg())) {
+		p = this->root;
+		for (;;) {
+			if (p->getLft() != NULL && !(now < p->getLft()->getAgg()))
+				p = p->getLft();
+			else if (!p->isDead() && !(now < p->getRcd()->expires))
+				break;
+			else
+				p = p->getRgt();
+		}
+		this->unlink(p);
+		delete p;
+		++n;
+	}
+	return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//        NAME: find
+// DESCRIPTION: To find the record of a live entry.
+//   ARGUMENTS: const T1 &id - the key
+//				const TM &now - the current time
+// USES GLOBAL: none
+// MODIFIES GL: none
+//     RETURNS: T2* - NULL if the key is not found or has expired
+//      AUTHOR: agent
+// AUTHOR/DATE: agent 2026-10-19
+//							agent 2026-10-19
+////////////////////////////////////////////////////////////////////////////////
+template<class T1, class T2, class TM>
+T2 *TTLTree<T1, T2, TM>::find(const T1 &id, const TM &now) const {
+	const Node<T1, TTLRCD<T2, TM>, MINEXP<T2, TM> > *node = this->findNode(id);
+	if (node == NULL || !(now < node->getRcd()->expires))
+		return NULL;
+	return &node->getRcd()->rcd;
+}
+
+#endif
@@ -0,0 +1,320 @@
+/*
+bench.cpp
+
+Benchmark of AVLTree and BucketAVLTree on trees much larger than the cache.
+Build it twice to compare the plain and the prefetching descents:
+
+	g++ -O2 -pthread -o bench bench.cpp
+	g++ -O2 -pthread -DAVL_PREFETCH -o bench_pf bench.cpp
+
+Build it with -std=c++20 to add the coroutine lookups, coFind.
+
+Usage: bench [nodes] [lookups] [avl|wavl|wb|all]
+       bench stress [keys]
+       bench sharded [threads] [keys]
+       bench strings [keys]
+
+The last argument picks the balance policy of AVLTree; the churn test then
+deletes and reinserts random keys, the write-heavy case where they differ.
+
+The stress test inserts distinct 64-bit keys in random order into a set until
+it holds "keys" of them (4G by default, past 2^31, for a large-memory
+machine), and reports the throughput and the resident bytes per key as it
+grows.
+
+The sharded test has every thread insert its share of random keys into one
+AVLTree behind a single mutex, then into a ShardedAVLTree with 4 shards per
+thread, by hash and by range.
+
+The strings test stores URL like keys with long shared prefixes in an
+AVLTree<string, int> and in a FrozenStringTree<int>, and compares their
+memory and lookup times. Both are counted the same way, by the bytes of the
+blocks they hold: for the AVLTree its nodes, records and the heap buffers of
+its keys, with the allocator's rounding and headers, from stats(); for the
+FrozenStringTree its three arrays, from getBytes(). Resident growth would not do here, as the
+second tree reuses the memory the first one freed.
+
+*/
+
+#include "AVLTree.h"
+#include "BucketAVLTree.h"
+#include "ShardedAVLTree.h"
+#include "FrozenStringTree.h"
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+static unsigned long long seed = 88172645463325252ULL;
+
+unsigned int rnd() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned int)seed;
+}
+
+double since(clock_t start) {
+	return double(clock() - start) / CLOCKS_PER_SEC;
+}
+
+template<class T1, class T2, class Aug, class Bal>
+int depth(const Node<T1, T2, Aug, Bal> *node) {
+	if (node == NULL)
+		return 0;
+	return 1 + MAX(depth(node->getLft()), depth(node->getRgt()));
+}
+
+// the resident memory of the process in bytes, 0 where /proc is missing
+double resident() {
+	long long pages = 0, rss = 0;
+	FILE *f = fopen("/proc/self/statm", "r");
+	if (f == NULL)
+		return 0;
+	if (fscanf(f, "%lld %lld", &pages, &rss) != 2)
+		rss = 0;
+	fclose(f);
+	return double(rss) * 4096;
+}
+
+// the heap block of a string's characters with the allocator's rounding and
+// header, 0 for a short one kept inside the string
+double heapOf(const string &s) {
+	const char *p = s.data();
+	if (p >= (const char *)&s && p < (const char *)(&s + 1))
+		return 0;
+	return double(s.capacity() + 1 + AVLSTATS::slack(p, s.capacity() + 1) + sizeof(size_t));
+}
+
+// a bijection on 64 bits, so that the keys i = 0, 1, 2... are distinct but
+// scattered without keeping a permutation of billions of them
+long long scatter(unsigned long long x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return (long long)(x ^ (x >> 31));
+}
+
+void stress(AVLSIZE n) {
+	AVLTree<long long> AT;
+	AVLSIZE i = 0, last = 0, mark = 1 << 20;
+	double base = resident();
+	clock_t start = clock(), lap = start;
+
+	printf("== stress, %d bytes per node\n", (int)sizeof(Node<long long>));
+	while (i < n) {
+		AT.Insert(scatter(i));
+		if (++i == mark || i == n) {
+			printf("%12lld keys: %.0f ns/insert, %.1f bytes/key, height %d, %.1fs\n",
+				AT.getSize(), since(lap) * 1e9 / (i - last), (resident() - base) / i,
+				AT.getHeight(), since(start));
+			lap = clock();
+			last = i;
+			mark *= 2;
+		}
+	}
+	for (i = 0; i < n; i += 1 + n / 1000000)
+		if (!AT.contains(scatter(i)))
+			printf("lost key %lld\n", i);
+}
+
+// time "threads" threads, each calling work(t) once
+template<class F>
+double parallel(int threads, F work) {
+	vector<std::thread> pool;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int t = 0; t < threads; t++)
+		pool.push_back(std::thread(work, t));
+	for (int t = 0; t < threads; t++)
+		pool[t].join();
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void sharded(int threads, int n) {
+	vector<int> keys(n), splits;
+	AVLTree<int> single;
+	std::mutex lock;
+	ShardedAVLTree<int> byHash(4 * threads);
+	int per = n / threads;
+	double t;
+
+	for (int i = 0; i < n; i++)
+		keys[i] = (int)(rnd() & 0x7fffffff);
+	for (int i = 1; i < 4 * threads; i++)
+		splits.push_back((int)(0x7fffffffLL * i / (4 * threads)));
+	ShardedAVLTree<int> byRange(splits);
+
+	printf("== sharded, %d threads, %d keys\n", threads, n);
+	t = parallel(threads, [&](int k) {
+		for (int i = k * per; i < (k + 1) * per; i++) {
+			std::lock_guard<std::mutex> hold(lock);
+			single.Insert(keys[i]);
+		}
+	});
+	printf("one lock   %.2f Minserts/s\n", per * threads / t / 1e6);
+	t = parallel(threads, [&](int k) {
+		for (int i = k * per; i < (k + 1) * per; i++)
+			byHash.Insert(keys[i]);
+	});
+	printf("by hash    %.2f Minserts/s\n", per * threads / t / 1e6);
+	t = parallel(threads, [&](int k) {
+		for (int i = k * per; i < (k + 1) * per; i++)
+			byRange.Insert(keys[i]);
+	});
+	printf("by range   %.2f Minserts/s, %lld keys\n", per * threads / t / 1e6, byRange.getSize());
+}
+
+void strings(int n) {
+	const char *hosts[] = { "https://www.example.com/", "https://static.example.com/assets/", "http://intranet.corp.example/wiki/" };
+	const char *dirs[] = { "products/", "users/profile/", "search?q=", "img/thumbs/large/" };
+	vector<string> ids(n), keys;
+	vector<int> rcds(n);
+	char tail[32];
+	double bytes;
+	clock_t start;
+	int hit = 0;
+
+	for (int i = 0; i < n; i++) {
+		sprintf(tail, "%u", rnd() % 100000000);
+		ids[i] = string(hosts[rnd() % 3]) + dirs[rnd() % 4] + tail;
+		rcds[i] = i;
+	}
+	for (int i = 0; i < n; i++)
+		keys.push_back(rnd() % 2 ? ids[rnd() % n] : ids[rnd() % n] + "x");
+
+	printf("== strings, %d keys\n", n);
+	{
+		AVLTree<string, int> AT;
+		AVLSTATS st;
+		const Node<string, int> *p;
+		for (int i = 0; i < n; i++)
+			AT.Insert(ids[i], rcds[i]);
+		st = AT.stats();
+		bytes = double(st.nodeBytes + st.rcdBytes + st.slackBytes);
+		// the header of the node's block and its record's, which stats() leaves out
+		for (p = AT.findNode(*min_element(ids.begin(), ids.end())); p != NULL; p = p->next())
+			bytes += heapOf(p->getID()) + 2 * sizeof(size_t);
+		start = clock();
+		for (int i = 0; i < n; i++)
+			hit += AT.find(keys[i]) != NULL;
+		printf("AVLTree          %.1f bytes/key, %.0f ns/lookup, %d hits\n", bytes / AT.getSize(), since(start) * 1e9 / n, hit);
+	}
+	hit = 0;
+	FrozenStringTree<int> FT(ids.data(), rcds.data(), n);
+	start = clock();
+	for (int i = 0; i < n; i++)
+		hit += FT.find(keys[i]) != NULL;
+	printf("FrozenStringTree %.1f bytes/key, %.0f ns/lookup, %d hits\n", double(FT.getBytes()) / FT.getSize(), since(start) * 1e9 / n, hit);
+}
+
+template<class Bal>
+void run(const char *name, const vector<int> &ids, const vector<int> &keys) {
+	int n = (int)ids.size(), q = (int)keys.size(), hit = 0;
+	AVLTree<int, NULLT, NOAUG, Bal> AT;
+	vector<NULLT *> rcds(q);
+	const Node<int, NULLT, NOAUG, Bal> *top;
+	clock_t start;
+
+	printf("== %s\n", name);
+	start = clock();
+	for (int i = 0; i < n; i++)
+		AT.Insert(ids[i]);
+	for (top = AT.findNode(ids[0]); top->getPar() != NULL; top = top->getPar());
+	printf("build    %lld nodes, depth %d: %.2fs\n", AT.getSize(), depth(top), since(start));
+
+#ifdef AVL_PREFETCH
+	printf("find     (AVL_PREFETCH): ");
+#else
+	printf("find     (plain): ");
+#endif
+	start = clock();
+	for (int i = 0; i < q; i++)
+		hit += AT.find(keys[i]) != NULL;
+	printf("%.0f ns/lookup, %d hits\n", since(start) * 1e9 / q, hit);
+
+	printf("findMany (groups): ");
+	start = clock();
+	hit = AT.findMany(&keys[0], &rcds[0], q);
+	printf("%.0f ns/lookup, %d hits\n", since(start) * 1e9 / q, hit);
+
+#ifdef AVL_CORO
+	printf("coFind   (round robin): ");
+	start = clock();
+	hit = 0;
+	for (int base = 0; base < q; base += 16) {
+		vector<AVLTASK<NULLT *> > tasks;
+		AVLSCHED sched;
+		for (int i = base; i < q && i < base + 16; i++) {
+			tasks.push_back(AT.coFind(keys[i]));
+			sched.add(tasks.back());
+		}
+		sched.run();
+		for (size_t i = 0; i < tasks.size(); i++)
+			hit += tasks[i].get() != NULL;
+	}
+	printf("%.0f ns/lookup, %d hits\n", since(start) * 1e9 / q, hit);
+#endif
+
+	printf("churn    (delete + insert): ");
+	start = clock();
+	for (int i = 0; i < q; i++) {
+		AT.Delete(ids[keys[i] % n]);
+		AT.Insert(ids[keys[i] % n]);
+	}
+	for (top = AT.findNode(ids[0]); top->getPar() != NULL; top = top->getPar());
+	printf("%.0f ns/pair, depth %d\n", since(start) * 1e9 / q, depth(top));
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && !strcmp(argv[1], "stress")) {
+		stress(argc > 2 ? atoll(argv[2]) : 4LL << 30);
+		return 0;
+	}
+	if (argc > 1 && !strcmp(argv[1], "sharded")) {
+		int threads = argc > 2 ? atoi(argv[2]) : (int)std::thread::hardware_concurrency();
+		sharded(threads > 0 ? threads : 1, argc > 3 ? atoi(argv[3]) : 4000000);
+		return 0;
+	}
+	if (argc > 1 && !strcmp(argv[1], "strings")) {
+		strings(argc > 2 ? atoi(argv[2]) : 1000000);
+		return 0;
+	}
+	int n = argc > 1 ? atoi(argv[1]) : 10000000;
+	int q = argc > 2 ? atoi(argv[2]) : 2000000;
+	const char *bal = argc > 3 ? argv[3] : "avl";
+	vector<int> ids(n), keys(q);
+	clock_t start;
+	int hit = 0;
+
+	// insert in random order so that neighbours in the tree are far apart
+	// in memory, as they are in a long lived tree
+	for (int i = 0; i < n; i++)
+		ids[i] = i * 2;
+	for (int i = n - 1; i > 0; i--)
+		swap(ids[i], ids[rnd() % (i + 1)]);
+	for (int i = 0; i < q; i++)
+		keys[i] = rnd() % (2 * n);
+
+	if (!strcmp(bal, "avl") || !strcmp(bal, "all"))
+		run<AVLBAL>("AVLBAL", ids, keys);
+	if (!strcmp(bal, "wavl") || !strcmp(bal, "all"))
+		run<WAVLBAL>("WAVLBAL", ids, keys);
+	if (!strcmp(bal, "wb") || !strcmp(bal, "all"))
+		run<WBBAL>("WBBAL", ids, keys);
+
+	printf("== BucketAVLTree\n");
+	BucketAVLTree<int, NULLT, 32> BT;
+	start = clock();
+	for (int i = 0; i < n; i++)
+		BT.Insert(ids[i]);
+	printf("buckets  %lld nodes, height %d: %.2fs\n", BT.getBuckets(), BT.getHeight(), since(start));
+	printf("find     (buckets): ");
+	start = clock();
+	for (int i = 0; i < q; i++)
+		hit += BT.find(keys[i]) != NULL;
+	printf("%.0f ns/lookup, %d hits\n", since(start) * 1e9 / q, hit);
+	return 0;
+}
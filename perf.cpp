@@ -0,0 +1,285 @@
+/*
+perf.cpp
+
+A performance regression gate for the hot paths of AVLTree: find, Insert,
+Delete and the bulk build by insertBatch. Every workload runs on keys from a
+fixed seed, several times, and its time per operation and its allocations are
+written to a baseline file. Compare a later run against it to catch
+slowdowns before they are merged:
+
+	make perf-baseline      (once, before the change)
+	make perf-check         (after it; fails on a regression)
+
+or by hand:
+
+	perf run [file] [keys] [reps]
+	perf compare base current [threshold]
+
+"run" writes one line per workload to "file" (stdout by default): the name,
+the keys, the operations and allocations of one repetition, the median ns/op
+and the ns/op of every repetition, separated by tabs. The allocations are
+counted by a global operator new, so they are exact and the same on every
+run.
+
+"compare" flags a workload whose median ns/op grew by more than the
+threshold (5% by default), but only if the rank sum test (Mann-Whitney U)
+over the repetitions says that it is slower at p < 0.05, so that noise is
+not reported. Any growth in allocations per operation is flagged as well.
+It exits with 1 if anything is flagged.
+
+The baseline is only meaningful on the machine and compiler that made it.
+
+*/
+
+#include "AVLTree.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <new>
+#include <atomic>
+using namespace std;
+
+static std::atomic<long long> allocs(0);
+
+void *operator new(size_t bytes) {
+	void *p;
+	allocs.fetch_add(1, std::memory_order_relaxed);
+	p = malloc(bytes != 0 ? bytes : 1);
+	if (p == NULL)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t bytes) {
+	return operator new(bytes);
+}
+
+void operator delete(void *p) noexcept {
+	free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+	free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+	free(p);
+}
+
+static unsigned long long seed;
+
+unsigned int rnd() {
+	seed ^= seed << 13;
+	seed ^= seed >> 7;
+	seed ^= seed << 17;
+	return (unsigned int)seed;
+}
+
+struct RESULT {
+	string name;
+	long long keys, ops, allocs;
+	vector<double> ns;	// per operation, one per repetition
+
+	double median() const;
+};
+
+double RESULT::median() const {
+	vector<double> s(ns);
+	sort(s.begin(), s.end());
+	if (s.empty())
+		return 0;
+	return s.size() % 2 ? s[s.size() / 2] : (s[s.size() / 2 - 1] + s[s.size() / 2]) / 2;
+}
+
+// the workloads share these: "ids" are the even keys in random order, and
+// "probes" the same keys in another order for find_hit and delete
+struct DATA {
+	vector<int> ids, probes, misses, rcds;
+};
+
+// time work(tree) on a tree prepared by setup(tree) "reps" times, counting
+// the allocations of the last repetition. The time is the CPU time of the
+// process, as in bench.cpp, so that other processes add less noise.
+template<class S, class W>
+RESULT measure(const char *name, const DATA &d, int reps, S setup, W work) {
+	RESULT r;
+	long long before;
+	clock_t start;
+	r.name = name;
+	r.keys = r.ops = (long long)d.ids.size();
+	for (int i = 0; i < reps; i++) {
+		AVLTree<int, int> *AT = new AVLTree<int, int>;
+		setup(*AT);
+		before = allocs.load();
+		start = clock();
+		work(*AT);
+		r.allocs = allocs.load() - before;
+		r.ns.push_back(double(clock() - start) / CLOCKS_PER_SEC * 1e9 / r.ops);
+		delete AT;
+	}
+	return r;
+}
+
+int run(const char *file, int n, int reps) {
+	DATA d;
+	vector<RESULT> out;
+	volatile long long sink = 0;
+
+	if (n < 1 || reps < 1) {
+		fprintf(stderr, "keys and reps must be positive\n");
+		return 2;
+	}
+	seed = 88172645463325252ULL;
+	d.ids.resize(n);
+	d.rcds.resize(n);
+	for (int i = 0; i < n; i++) {
+		d.ids[i] = i * 2;
+		d.rcds[i] = i;
+	}
+	for (int i = n - 1; i > 0; i--)
+		swap(d.ids[i], d.ids[rnd() % (i + 1)]);
+	d.probes = d.ids;
+	for (int i = n - 1; i > 0; i--)
+		swap(d.probes[i], d.probes[rnd() % (i + 1)]);
+	for (int i = 0; i < n; i++)
+		d.misses.push_back((int)(rnd() % n) * 2 + 1);
+
+	auto empty = [](AVLTree<int, int> &) {};
+	auto full = [&d, n](AVLTree<int, int> &AT) {
+		for (int i = 0; i < n; i++)
+			AT.Insert(d.ids[i], d.rcds[i]);
+	};
+
+	out.push_back(measure("insert", d, reps, empty, [&](AVLTree<int, int> &AT) {
+		for (int i = 0; i < n; i++)
+			AT.Insert(d.ids[i], d.rcds[i]);
+	}));
+	out.push_back(measure("find_hit", d, reps, full, [&](AVLTree<int, int> &AT) {
+		for (int i = 0; i < n; i++)
+			sink += AT.find(d.probes[i]) != NULL;
+	}));
+	out.push_back(measure("find_miss", d, reps, full, [&](AVLTree<int, int> &AT) {
+		for (int i = 0; i < n; i++)
+			sink += AT.find(d.misses[i]) != NULL;
+	}));
+	out.push_back(measure("delete", d, reps, full, [&](AVLTree<int, int> &AT) {
+		for (int i = 0; i < n; i++)
+			AT.Delete(d.probes[i]);
+	}));
+	out.push_back(measure("build_batch", d, reps, empty, [&](AVLTree<int, int> &AT) {
+		sink += AT.insertBatch(&d.ids[0], &d.rcds[0], n);
+	}));
+
+	FILE *f = file != NULL ? fopen(file, "w") : stdout;
+	if (f == NULL) {
+		fprintf(stderr, "cannot write %s\n", file);
+		return 2;
+	}
+	fprintf(f, "# name\tkeys\tops\tallocs\tmedian_ns\tns_per_rep\n");
+	for (size_t i = 0; i < out.size(); i++) {
+		fprintf(f, "%s\t%lld\t%lld\t%lld\t%.2f\t", out[i].name.c_str(), out[i].keys, out[i].ops, out[i].allocs, out[i].median());
+		for (size_t j = 0; j < out[i].ns.size(); j++)
+			fprintf(f, "%s%.2f", j ? "," : "", out[i].ns[j]);
+		fprintf(f, "\n");
+		if (f != stdout)
+			printf("%-12s %8.1f ns/op  %6.3f allocs/op\n", out[i].name.c_str(), out[i].median(), double(out[i].allocs) / out[i].ops);
+	}
+	if (f != stdout)
+		fclose(f);
+	return 0;
+}
+
+bool load(const char *file, vector<RESULT> &out) {
+	ifstream in(file);
+	string line, list, item;
+	if (!in) {
+		fprintf(stderr, "cannot read %s\n", file);
+		return false;
+	}
+	while (getline(in, line)) {
+		RESULT r;
+		double med;
+		if (line.empty() || line[0] == '#')
+			continue;
+		istringstream fields(line);
+		if (!(fields >> r.name >> r.keys >> r.ops >> r.allocs >> med >> list)) {
+			fprintf(stderr, "%s: bad line: %s\n", file, line.c_str());
+			return false;
+		}
+		istringstream samples(list);
+		while (getline(samples, item, ','))
+			r.ns.push_back(atof(item.c_str()));
+		out.push_back(r);
+	}
+	return true;
+}
+
+// the one sided p value of the rank sum test that b is slower than a, by the
+// normal approximation with a continuity correction
+double slower(const vector<double> &a, const vector<double> &b) {
+	double u = 0, n1 = (double)a.size(), n2 = (double)b.size(), mean, sd;
+	for (size_t i = 0; i < b.size(); i++)
+		for (size_t j = 0; j < a.size(); j++)
+			u += b[i] > a[j] ? 1 : b[i] == a[j] ? 0.5 : 0;
+	mean = n1 * n2 / 2;
+	sd = sqrt(n1 * n2 * (n1 + n2 + 1) / 12);
+	if (sd == 0)
+		return 1;
+	return 0.5 * erfc((u - mean - 0.5) / sd / sqrt(2.0));
+}
+
+int compare(const char *baseFile, const char *curFile, double threshold) {
+	vector<RESULT> base, cur;
+	int bad = 0;
+	if (!load(baseFile, base) || !load(curFile, cur))
+		return 2;
+
+	printf("%-12s %10s %10s %8s %8s %14s\n", "workload", "base ns", "now ns", "change", "p", "allocs/op");
+	for (size_t i = 0; i < cur.size(); i++) {
+		const RESULT *b = NULL;
+		for (size_t j = 0; j < base.size(); j++)
+			if (base[j].name == cur[i].name)
+				b = &base[j];
+		if (b == NULL) {
+			printf("%-12s not in the baseline\n", cur[i].name.c_str());
+			continue;
+		}
+		if (b->keys != cur[i].keys)
+			printf("%-12s warning: %lld keys against %lld in the baseline\n", cur[i].name.c_str(), cur[i].keys, b->keys);
+		double was = b->median(), now = cur[i].median(), p = slower(b->ns, cur[i].ns);
+		double allocWas = double(b->allocs) / b->ops, allocNow = double(cur[i].allocs) / cur[i].ops;
+		bool slow = now > was * (1 + threshold) && p < 0.05;
+		bool alloc = cur[i].allocs * b->ops > b->allocs * cur[i].ops;
+		printf("%-12s %10.1f %10.1f %+7.1f%% %8.4f %6.3f->%-6.3f %s\n", cur[i].name.c_str(), was, now,
+			(now / was - 1) * 100, p, allocWas, allocNow, slow && alloc ? "SLOWER, MORE ALLOCS" : slow ? "SLOWER" : alloc ? "MORE ALLOCS" : "ok");
+		bad += slow || alloc;
+	}
+	for (size_t j = 0; j < base.size(); j++) {
+		bool found = false;
+		for (size_t i = 0; i < cur.size(); i++)
+			found = found || base[j].name == cur[i].name;
+		if (!found)
+			printf("%-12s missing from the current run\n", base[j].name.c_str());
+	}
+	printf("%d regression%s\n", bad, bad == 1 ? "" : "s");
+	return bad > 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+	if (argc > 1 && !strcmp(argv[1], "run"))
+		return run(argc > 2 && strcmp(argv[2], "-") ? argv[2] : NULL,
+			argc > 3 ? atoi(argv[3]) : 1 << 18, argc > 4 ? atoi(argv[4]) : 11);
+	if (argc > 3 && !strcmp(argv[1], "compare"))
+		return compare(argv[2], argv[3], argc > 4 ? atof(argv[4]) : 0.05);
+	fprintf(stderr, "usage: perf run [file] [keys] [reps]\n       perf compare base current [threshold]\n");
+	return 2;
+}
@@ -1,4 +1,13 @@
 #include "AVLTree.h"
+#include "IntervalTree.h"
+#include "AVLMultiTree.h"
+#include "BucketAVLTree.h"
+#include "TTLTree.h"
+#include "LRUTree.h"
+#include "ShardedAVLTree.h"
+#include "DurableAVLTree.h"
+#include "ReplicatedAVLTree.h"
+#include "FrozenStringTree.h"
 #include <string>
 using namespace std;
 
@@ -24,6 +33,14 @@ bool operator>(const A &a, const A &b) {
 	return (a.x > b.x);
 }
 
+class SUM {
+public :
+	typedef int value_type;
+	static int identity() { return 0; }
+	static int lift(const int &id, const int *rcd) { return *rcd; }
+	static int combine(const int &a, const int &b) { return a + b; }
+};
+
 int cmp(const A &a, const A &b) {
 	if (a.x > b.x)
 		return 1;
@@ -115,5 +132,242 @@ int main() {
 		AT8.print()*/
 		
 	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int> AT9;
+		for (int i = 1; i < 16; i += 2)
+			AT9.InsertNear(NULL, i);	// appended at the finger
+		AT9.InsertNear(AT9.findNode(8 - 1), 8);
+		cout << (AT9.fingerFind(9) != NULL) << ' ' << (AT9.fingerFind(10) != NULL) << endl;
+		for (const Node<int> *p = AT9.findNode(5); p != NULL; p = p->next())
+			cout << p->getID() << ' ';
+		cout << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, int, SUM> AT10;
+		for (int i = 1; i < 16; i++)
+			AT10.Insert(i, i * 10);
+		AT10.Modify(4, 0);
+		AT10.Delete(5);
+		cout << AT10.rangeAggregate(3, 7) << ' ' << AT10.rangeAggregate(0, 100) << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		IntervalTree<int> IT1;
+		vector<const Node<INTERVAL<int>, NULLT, MAXEND<int> > *> hits;
+		IT1.Insert(1, 5);
+		IT1.Insert(3, 9);
+		IT1.Insert(6, 7);
+		IT1.Insert(10, 12);
+		IT1.stab(6, hits);
+		IT1.overlapQuery(8, 10, hits);
+		for (size_t i = 0; i < hits.size(); i++)
+			cout << '[' << hits[i]->getID().lo << ", " << hits[i]->getID().hi << "] ";
+		cout << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLMultiTree<int, int> MT1;
+		for (int i = 0; i < 10; i++)
+			MT1.Insert(i % 3, i);
+		MT1.eraseOne(1);
+		pair<int *, int *> recs = MT1.equalRange(1);
+		for (; recs.first != recs.second; ++recs.first)
+			cout << *recs.first << ' ';
+		cout << MT1.count(0) << ' ' << MT1.eraseAll(2) << ' ' << MT1.getSize() << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		int ids[] = { 9, 3, 12, 3, 7, 1, 15, 5 };
+		AVLTree<int> AT11;
+		cout << AT11.insertBatch(ids, 8) << ' ';
+		cout << AT11.eraseBatch(ids + 4, 4) << endl;
+		AT11.print();
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int> AT12;
+		cout << AT12.Insert(3) << AT12.Insert(5) << AT12.Insert(3) << ' ';
+		cout << AT12.contains(5) << AT12.Delete(5) << AT12.Delete(5) << ' ';
+		cout << AT12.contains(5) << AT12.contains(3) << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, int> AT13, AT14;
+		for (int i = 1; i <= 5; i++)
+			AT13.Insert(i, i * i);
+		Node<int, int> *moved = AT13.extract(4);
+		cout << moved->getID() << ' ' << *moved->getRcd() << ' ';
+		cout << AT14.InsertNode(moved) << ' ' << AT13.erase(4) << AT13.erase(5) << ' ';
+		cout << AT13.getSize() << ' ' << *AT14.find(4) << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		BucketAVLTree<int, int, 4> BT1;
+		for (int i = 20; i > 0; i--)
+			BT1.Insert(i, i * 10);
+		BT1.Delete(7);
+		cout << BT1.getSize() << ' ' << BT1.getBuckets() << ' ' << BT1.contains(7) << ' ';
+		cout << *BT1.find(13) << ' ' << BT1.getHeight() << ' ';
+		BT1.empty();
+		cout << BT1.getHeight() << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, NULLT, NOAUG, WAVLBAL> WT;
+		AVLTree<int, NULLT, NOAUG, WBBAL> BT2;
+		for (int i = 1; i <= 10; i++) {
+			WT.Insert(i);
+			BT2.Insert(i);
+		}
+		for (int i = 1; i <= 10; i += 2) {
+			WT.Delete(i);
+			BT2.Delete(i);
+		}
+		cout << WT.getSize() << ' ' << WT.getHeight() << ' ' << WT.getField() << ' ' << BT2.getHeight() << ' ' << BT2.getField() << endl;
+		WT.print();
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, int> AT15;
+		AT15.setLazy(0.5);
+		for (int i = 1; i <= 8; i++)
+			AT15.Insert(i, i);
+		AT15.Delete(2);
+		AT15.Delete(5);
+		cout << AT15.getSize() << ' ' << AT15.getTombs() << ' ' << AT15.contains(5) << ' ';
+		AT15.Insert(5, 50);
+		cout << *AT15.find(5) << ' ' << AT15.findNode(1)->next()->getID() << ' ';
+		AT15.compact();
+		cout << AT15.getSize() << ' ' << AT15.getTombs() << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		TTLTree<int, int> TT(0);
+		for (int i = 1; i <= 6; i++)
+			TT.Insert(i, i * 10, i * 5, 0);
+		cout << TT.nextExpiry() << ' ' << (TT.find(2, 12) == NULL) << ' ';
+		TT.touch(1, 40);
+		cout << TT.evictExpired(20, -1) << ' ' << TT.getSize() << ' ' << *TT.find(1, 20) << ' ';
+		cout << TT.Insert(5, 55, 60, 20) << ' ' << TT.nextExpiry() << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		LRUTree<int, int> one(1 << 20);
+		one.Insert(0, 0);
+		LRUTree<int, int> LT(3 * one.getBytes());
+		for (int i = 1; i <= 3; i++)
+			LT.Insert(i, i * 10);
+		LT.find(1);
+		LT.Insert(4, 40);
+		cout << LT.getSize() << ' ' << LT.contains(2) << ' ' << *LT.oldest() << ' ';
+		LT.setCapacity(LT.getBytes() / 3);
+		cout << LT.getSize() << ' ' << *LT.peek(4) << endl;
+	}
+#ifdef __GLIBC__
+	{
+		cout << "-------------------------------------------" << endl;
+		size_t before = mallinfo2().uordblks;
+		LRUTree<int, int> *big = new LRUTree<int, int>(1 << 20);
+		for (int i = 0; i < 100000; i++)
+			big->Insert(i, i);
+		double heap = double(mallinfo2().uordblks - before) / big->getBytes();
+		cout << big->getSize() << " entries, heap / getBytes() " << (heap > 0.98 && heap < 1.02 ? "within 2%" : "off") << endl;
+		delete big;
+	}
+#endif
+	{
+		cout << "-------------------------------------------" << endl;
+		vector<int> splits(1, 10);
+		ShardedAVLTree<int> ST1(splits), ST2(3);
+		for (int i = 0; i < 8; i++) {
+			ST1.Insert(i);
+			ST2.Insert(i * 7 % 8);
+		}
+		cout << ST1.shardSize(0) << ' ' << ST1.shardSize(1) << ' ';
+		cout << ST1.rebalance() << ' ' << ST1.shardSize(0) << ' ' << ST1.shardSize(1) << ' ';
+		ST1.inorder([](const Node<int> *p) { cout << p->getID(); });
+		cout << ' ' << ST2.getSize() << ' ';
+		ST2.inorder([](const Node<int> *p) { cout << p->getID(); });
+		cout << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		{
+			DurableAVLTree<int, int> DT1("test_durable", 4);
+			for (int i = 1; i <= 6; i++)
+				DT1.Insert(i, i * 10);
+			DT1.Delete(3);
+			DT1.Modify(4, 44);
+		}
+		{
+			DurableAVLTree<int, int> DT2("test_durable");
+			cout << DT2.getSize() << ' ' << DT2.contains(3) << ' ' << *DT2.find(4) << ' ' << DT2.getLogBytes() << endl;
+		}
+		remove("test_durable.wal");
+		remove("test_durable.ckpt");
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		ReplicatedAVLTree<int, int> RT(2);
+		int v = 0;
+		for (int i = 1; i <= 10; i++)
+			RT.Insert(i, i * 10, i % 2);
+		RT.Delete(5, 0);
+		RT.Modify(6, 66, 1);
+		RT.find(6, v, 0);
+		cout << RT.getSize(0) << ' ' << RT.getSize(1) << ' ' << RT.contains(5, 1) << ' ' << v << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<string, int> AT17;
+		AT17.Insert("/usr/lib/libc.so", 1);
+		AT17.Insert("/usr/lib/libm.so", 2);
+		AT17.Insert("/usr/local/bin", 3);
+		AT17.Insert("/usr/bin", 4);
+		FrozenStringTree<int> FT(AT17, 2);
+		cout << FT.getSize() << ' ' << *FT.find("/usr/lib/libm.so") << ' ' << FT.contains("/usr/lib") << ' ' << FT.getKey(3) << endl;
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, int> AT18;
+		for (int i = 1; i <= 20; i++)
+			AT18.Insert(i, i);
+		AVLSTATS st = AT18.stats();
+		cout << st.nodes << ' ' << st.height << ' ' << st.maxDepth << ' ' << st.balance[0] << endl;
+		st.toJSON();
+		AT18.toDot(cout, 1);
+	}
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int> AT19;
+		for (int i = 1; i <= 100; i++)
+			AT19.Insert(i);
+		cout << AT19.eraseRange(21, 80) << ' ' << AT19.getSize() << ' ' << AT19.lowerNode(21)->getID() << endl;
+		AVLCURSOR<int> cur(AT19, 1, 90);
+		int sum = 0;
+		while (!cur.done())
+			cur.scan([&sum](const Node<int> *node) { sum += node->getID(); }, 8);
+		cout << sum << endl;
+		AVLCURSOR<int> purge(AT19);
+		while (!purge.done())
+			cout << purge.erase(16) << ' ';
+		cout << AT19.getSize() << endl;
+	}
+#ifdef AVL_CORO
+	{
+		cout << "-------------------------------------------" << endl;
+		AVLTree<int, int> AT16;
+		AVLSCHED sched;
+		for (int i = 1; i <= 20; i++)
+			AT16.Insert(i, i * 10);
+		AVLTASK<int *> q1 = AT16.coFind(7), q2 = AT16.coFind(25);
+		sched.add(q1);
+		sched.add(q2);
+		sched.run();
+		cout << *q1.get() << ' ' << (q2.get() == NULL) << endl;
+	}
+#endif
 	system("pause");
 }